@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "nvl/data/Iterator.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/data/Range.h"
+
+namespace {
+
+using nvl::List;
+using nvl::Map;
+using nvl::Range;
+
+/// Baseline: iterating over a std::vector directly.
+void iterate_std_vector(benchmark::State &state) {
+    std::vector<U64> values(state.range(0));
+    std::iota(values.begin(), values.end(), 0);
+    for (auto _ : state) {
+        U64 sum = 0;
+        for (const U64 value : values) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(iterate_std_vector)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Iterating over a List, which goes through the type-erased Iterator.
+void iterate_list(benchmark::State &state) {
+    List<U64> values;
+    for (I64 i = 0; i < state.range(0); ++i) {
+        values.push_back(i);
+    }
+    for (auto _ : state) {
+        U64 sum = 0;
+        for (const U64 value : values) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(iterate_list)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Iterating over a Range, which additionally copies the begin iterator.
+void iterate_range(benchmark::State &state) {
+    List<U64> values;
+    for (I64 i = 0; i < state.range(0); ++i) {
+        values.push_back(i);
+    }
+    const Range<U64> range = values.range();
+    for (auto _ : state) {
+        U64 sum = 0;
+        for (const U64 value : range) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(iterate_range)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Baseline: iterating over the values of a std::unordered_map directly.
+void iterate_std_map_values(benchmark::State &state) {
+    std::unordered_map<U64, U64> map;
+    for (I64 i = 0; i < state.range(0); ++i) {
+        map[i] = i;
+    }
+    for (auto _ : state) {
+        U64 sum = 0;
+        for (const auto &[_, value] : map) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(iterate_std_map_values)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Iterating over the values of a Map through the type-erased Iterator.
+void iterate_map_values(benchmark::State &state) {
+    Map<U64, U64> map;
+    for (I64 i = 0; i < state.range(0); ++i) {
+        map[i] = i;
+    }
+    for (auto _ : state) {
+        U64 sum = 0;
+        for (const U64 value : map.values()) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(iterate_map_values)->RangeMultiplier(16)->Range(16, 65536);
+
+} // namespace
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/data/Set.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using nvl::List;
+using nvl::Map;
+using nvl::Pos;
+using nvl::Random;
+using nvl::Set;
+
+constexpr U64 kSeed = 0x5EED;
+
+/// Returns `count` random keys, and `count` more keys which are not in the first half.
+List<U64> random_keys(const U64 count) {
+    Random random(kSeed);
+    std::uniform_int_distribution<U64> distribution;
+    Set<U64> unique;
+    List<U64> keys;
+    while (keys.size() < 2 * count) {
+        const U64 key = distribution(random.engine());
+        if (!unique.has(key)) {
+            unique.insert(key);
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+void map_insert(benchmark::State &state) {
+    const U64 count = state.range(0);
+    const List<U64> keys = random_keys(count);
+    for (auto _ : state) {
+        Map<U64, U64> map;
+        for (U64 i = 0; i < count; ++i) {
+            map[keys[i]] = i;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(map_insert)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Looks up a mix of present and missing keys.
+void map_get(benchmark::State &state) {
+    const U64 count = state.range(0);
+    const List<U64> keys = random_keys(count);
+    Map<U64, U64> map;
+    for (U64 i = 0; i < count; ++i) {
+        map[keys[i]] = i;
+    }
+    for (auto _ : state) {
+        U64 found = 0;
+        for (const U64 key : keys) {
+            if (const U64 *value = map.get(key)) {
+                found += *value;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * count);
+}
+BENCHMARK(map_get)->RangeMultiplier(16)->Range(16, 65536);
+
+void map_remove(benchmark::State &state) {
+    const U64 count = state.range(0);
+    const List<U64> keys = random_keys(count);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Map<U64, U64> map;
+        for (U64 i = 0; i < count; ++i) {
+            map[keys[i]] = i;
+        }
+        state.ResumeTiming();
+        for (U64 i = 0; i < count; ++i) {
+            map.remove(keys[i]);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(map_remove)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Map keyed by position, as used for RTree node entries.
+void map_pos_get(benchmark::State &state) {
+    const I64 side = state.range(0);
+    Map<Pos<2>, U64> map;
+    for (I64 i = 0; i < side; ++i) {
+        for (I64 j = 0; j < side; ++j) {
+            map[{i, j}] = i * side + j;
+        }
+    }
+    for (auto _ : state) {
+        U64 found = 0;
+        for (I64 i = 0; i < side; ++i) {
+            for (I64 j = 0; j < side; ++j) {
+                found += *map.get({i, j});
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(map_pos_get)->RangeMultiplier(4)->Range(4, 256);
+
+void set_insert(benchmark::State &state) {
+    const U64 count = state.range(0);
+    const List<U64> keys = random_keys(count);
+    for (auto _ : state) {
+        Set<U64> set;
+        for (U64 i = 0; i < count; ++i) {
+            set.insert(keys[i]);
+        }
+        benchmark::DoNotOptimize(set.size());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(set_insert)->RangeMultiplier(16)->Range(16, 65536);
+
+/// Checks membership for a mix of present and missing keys.
+void set_has(benchmark::State &state) {
+    const U64 count = state.range(0);
+    const List<U64> keys = random_keys(count);
+    Set<U64> set;
+    for (U64 i = 0; i < count; ++i) {
+        set.insert(keys[i]);
+    }
+    for (auto _ : state) {
+        U64 found = 0;
+        for (const U64 key : keys) {
+            found += set.has(key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * count);
+}
+BENCHMARK(set_has)->RangeMultiplier(16)->Range(16, 65536);
+
+} // namespace
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+#include "nvl/data/List.h"
+#include "nvl/data/SipHash.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+
+namespace {
+
+using nvl::Box;
+using nvl::List;
+using nvl::Pos;
+
+/// Measures sip_hash13 and sip_hash24 over byte strings of length `state.range(0)`.
+template <U64 (*Hash)(const char *, U64)>
+void sip_hash_bytes(benchmark::State &state) {
+    const List<char> bytes(state.range(0), 'x');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Hash(&bytes[0], bytes.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(sip_hash_bytes<nvl::sip_hash13>)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK(sip_hash_bytes<nvl::sip_hash24>)->RangeMultiplier(4)->Range(8, 4096);
+
+/// Measures std::hash on the geometric keys used in RTree node maps and BRTree edges.
+template <typename Value>
+void sip_hash_value(benchmark::State &state, const Value &value) {
+    const std::hash<Value> hasher;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hasher(value));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(sip_hash_value, pos2, Pos<2>(3, 4));
+BENCHMARK_CAPTURE(sip_hash_value, pos3, Pos<3>(3, 4, 5));
+BENCHMARK_CAPTURE(sip_hash_value, box2, Box<2>({0, 0}, {15, 15}));
+BENCHMARK_CAPTURE(sip_hash_value, box3, Box<3>({0, 0, 0}, {15, 15, 15}));
+
+} // namespace
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "nvl/data/List.h"
+#include "nvl/data/UnionFind.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using nvl::List;
+using nvl::Random;
+using nvl::UnionFind;
+
+constexpr U64 kSeed = 0x5EED;
+
+/// Measures grouping `state.range(0)` items using random pairs, with roughly one pair per item.
+void union_find_add(benchmark::State &state) {
+    const U64 count = state.range(0);
+    Random random(kSeed);
+    std::uniform_int_distribution<U64> distribution(0, count - 1);
+    List<std::pair<U64, U64>> pairs;
+    for (U64 i = 0; i < count; ++i) {
+        pairs.emplace_back(distribution(random.engine()), distribution(random.engine()));
+    }
+    for (auto _ : state) {
+        UnionFind<U64> sets;
+        for (const auto &[a, b] : pairs) {
+            sets.add(a, b);
+        }
+        benchmark::DoNotOptimize(sets.sets().begin());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(union_find_add)->RangeMultiplier(8)->Range(64, 32768);
+
+/// Measures grouping items which form a single chain, the worst case for merging existing groups.
+void union_find_chain(benchmark::State &state) {
+    const U64 count = state.range(0);
+    for (auto _ : state) {
+        UnionFind<U64> sets;
+        for (U64 i = 1; i < count; ++i) {
+            sets.add(i - 1, i);
+        }
+        benchmark::DoNotOptimize(sets.has(0));
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(union_find_chain)->RangeMultiplier(8)->Range(64, 32768);
+
+} // namespace
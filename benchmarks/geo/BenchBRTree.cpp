@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+
+#include "nvl/geo/Box.h"
+#include "nvl/geo/BRTree.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/test/LabeledBox.h"
+
+namespace {
+
+using nvl::Box;
+using nvl::BRTree;
+using nvl::Pos;
+using nvl::test::LabeledBox;
+
+constexpr I64 kPartSize = 16;
+
+/// Fills `tree` with a square grid of `side` x `side` adjacent parts, similar to the parts of a large block.
+/// The part at `skip` is left out.
+void fill_grid(BRTree<2, LabeledBox> &tree, const I64 side, const Pos<2> &skip) {
+    U64 id = 0;
+    for (I64 i = 0; i < side; ++i) {
+        for (I64 j = 0; j < side; ++j) {
+            const Pos<2> min{i * kPartSize, j * kPartSize};
+            if (min != skip) {
+                tree.emplace(id++, Box<2>(min, min + kPartSize - 1));
+            }
+        }
+    }
+}
+
+/// Measures recomputing all edges after a single part changes.
+/// Each iteration removes and re-adds one part in the middle of the grid to invalidate the cached edges.
+void brtree_edges(benchmark::State &state) {
+    const I64 side = state.range(0);
+    const Pos<2> mid = Pos<2>::fill(side / 2 * kPartSize);
+    const Box<2> hole(mid, mid + kPartSize - 1);
+    BRTree<2, LabeledBox> tree;
+    fill_grid(tree, side, mid);
+    auto part = tree.emplace(side * side, hole);
+    for (auto _ : state) {
+        tree.remove(part);
+        part = tree.emplace(side * side, hole);
+        U64 count = 0;
+        for (const auto &edge : tree.edges()) {
+            count += edge.bbox().min[0];
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(brtree_edges)->RangeMultiplier(2)->Range(2, 32)->Unit(benchmark::kMicrosecond);
+
+} // namespace
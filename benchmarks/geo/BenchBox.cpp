@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include "nvl/bench/RandomBoxes.h"
+#include "nvl/data/List.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using nvl::Box;
+using nvl::Edge;
+using nvl::List;
+using nvl::Pos;
+using nvl::Random;
+using nvl::bench::random_boxes;
+
+constexpr U64 kSeed = 0x5EED;
+constexpr U64 kPairs = 1024;
+
+/// Measures Box::diff on random pairs of boxes which overlap in a variety of ways.
+template <U64 N>
+void box_diff(benchmark::State &state) {
+    Random random(kSeed);
+    const auto lhs = random_boxes<N>(random, kPairs, 32, 32);
+    const auto rhs = random_boxes<N>(random, kPairs, 32, 32);
+    U64 i = 0;
+    for (auto _ : state) {
+        const U64 idx = i++ % kPairs;
+        benchmark::DoNotOptimize(lhs[idx].diff(rhs[idx]).size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(box_diff<2>);
+BENCHMARK(box_diff<3>);
+
+/// Measures Box::diff against a list of `state.range(0)` boxes, as used when removing overlapping parts.
+void box_diff_range(benchmark::State &state) {
+    Random random(kSeed);
+    const Box<2> box({0, 0}, {63, 63});
+    const auto others = random_boxes<2>(random, state.range(0), 64, 16);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(box.diff(others.range()).size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(box_diff_range)->RangeMultiplier(4)->Range(1, 64);
+
+template <U64 N>
+void box_edges(benchmark::State &state) {
+    const Box<N> box(Pos<N>::zero, Pos<N>::fill(31));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(box.edges().size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(box_edges<2>);
+BENCHMARK(box_edges<3>);
+
+/// Measures Edge::diff, which dominates BRTree edge recomputation.
+void edge_diff(benchmark::State &state) {
+    Random random(kSeed);
+    const Box<2> box({8, 8}, {55, 55}); // Leaves room for edges within the range of others
+    const auto others = random_boxes<2>(random, state.range(0), 64, 16);
+    const auto edges = box.edges();
+    for (auto _ : state) {
+        U64 count = 0;
+        for (const Edge<2> &edge : edges) {
+            count += edge.diff(others.range()).size();
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(edge_diff)->RangeMultiplier(4)->Range(1, 64);
+
+} // namespace
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include "nvl/bench/RandomBoxes.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Ref.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/geo/RTree.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using nvl::Box;
+using nvl::List;
+using nvl::Pos;
+using nvl::Random;
+using nvl::Ref;
+using nvl::RTree;
+using nvl::bench::random_boxes;
+using nvl::bench::random_pos;
+
+/// Mutable item type so that benchmarks can move items in place.
+struct Body {
+    Body(const U64 i, const Box<2> &b) : id(i), box(b) {}
+    pure const Box<2> &bbox() const { return box; }
+    U64 id;
+    Box<2> box;
+};
+
+using Tree = RTree<2, Body>;
+
+constexpr U64 kSeed = 0x5EED;
+constexpr I64 kExtent = 2048; // Side length of the square region items are placed in
+constexpr I64 kMaxShape = 32; // Maximum side length of each item
+constexpr I64 kQuerySize = 64;
+
+/// Runs each benchmark with a sparse, medium, and dense population of the same region.
+void densities(benchmark::internal::Benchmark *bench) {
+    for (const I64 count : {256, 2048, 16384}) {
+        bench->Arg(count);
+    }
+}
+
+List<Ref<Body>> populate(Tree &tree, const List<Box<2>> &boxes) {
+    List<Ref<Body>> refs;
+    U64 id = 0;
+    for (const Box<2> &box : boxes) {
+        refs.push_back(tree.emplace(id++, box));
+    }
+    return refs;
+}
+
+void rtree_insert(benchmark::State &state) {
+    Random random(kSeed);
+    const auto boxes = random_boxes<2>(random, state.range(0), kExtent, kMaxShape);
+    for (auto _ : state) {
+        Tree tree;
+        populate(tree, boxes);
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(rtree_insert)->Apply(densities)->Unit(benchmark::kMillisecond);
+
+void rtree_remove(benchmark::State &state) {
+    Random random(kSeed);
+    const auto boxes = random_boxes<2>(random, state.range(0), kExtent, kMaxShape);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Tree tree;
+        const List<Ref<Body>> refs = populate(tree, boxes);
+        state.ResumeTiming();
+        for (const Ref<Body> &ref : refs) {
+            tree.remove(ref);
+        }
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(rtree_remove)->Apply(densities)->Unit(benchmark::kMillisecond);
+
+/// Moves every item by a small random offset, similar to a tick in which all entities are falling.
+void rtree_move(benchmark::State &state) {
+    Random random(kSeed);
+    const auto boxes = random_boxes<2>(random, state.range(0), kExtent, kMaxShape);
+    List<Pos<2>> offsets;
+    for (U64 i = 0; i < 64; ++i) {
+        offsets.push_back(random_pos<2>(random, 0, 4));
+    }
+    Tree tree;
+    List<Ref<Body>> refs = populate(tree, boxes);
+    U64 step = 0;
+    for (auto _ : state) {
+        // Alternate directions to keep the population within the same region.
+        const I64 sign = (step++ % 2 == 0) ? 1 : -1;
+        U64 i = 0;
+        for (Ref<Body> &ref : refs) {
+            const Box<2> prev = ref->box;
+            ref->box = prev + offsets[i++ % offsets.size()] * sign;
+            tree.move(ref, prev);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(rtree_move)->Apply(densities)->Unit(benchmark::kMillisecond);
+
+void rtree_query(benchmark::State &state) {
+    Random random(kSeed);
+    const auto boxes = random_boxes<2>(random, state.range(0), kExtent, kMaxShape);
+    const auto queries = random_boxes<2>(random, 1024, kExtent, kQuerySize);
+    Tree tree;
+    populate(tree, boxes);
+    U64 i = 0;
+    for (auto _ : state) {
+        U64 found = 0;
+        for (const Ref<Body> &ref : tree[queries[i++ % queries.size()]]) {
+            found += ref->id;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(rtree_query)->Apply(densities);
+
+void rtree_components(benchmark::State &state) {
+    Random random(kSeed);
+    const auto boxes = random_boxes<2>(random, state.range(0), kExtent, kMaxShape);
+    Tree tree;
+    populate(tree, boxes);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tree.components().size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(rtree_components)->Apply(densities)->Unit(benchmark::kMillisecond);
+
+} // namespace
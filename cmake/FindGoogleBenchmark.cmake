@@ -0,0 +1,17 @@
+if (NOT _GOOGLEBENCHMARK_FOUND)
+    set(_GOOGLEBENCHMARK_FOUND TRUE)
+
+    # Prefer an installed copy so the benchmarks can be configured without network access.
+    find_package(benchmark CONFIG QUIET)
+    if (NOT benchmark_FOUND)
+        include(FetchContent)
+        FetchContent_Declare(
+                googlebenchmark
+                URL https://github.com/google/benchmark/archive/refs/tags/v1.8.3.zip
+        )
+        set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL " " FORCE)
+        set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL " " FORCE)
+        set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL " " FORCE)
+        FetchContent_MakeAvailable(googlebenchmark)
+    endif ()
+endif ()
@@ -1,35 +1,40 @@
-#include "nvl/entity/Entity.h"
-#include "nvl/tool/ToolBelt.h"
-#include "nvl/ui/RayWindow.h"
-#include "nvl/world/World.h"
-
-namespace nvl {
-
-void init_world(Window *window, World<2> *world) {
-    const Material bulwark = Material::get<Bulwark>();
-    const Pos<2> min = {0, window->height() - 50};
-    const Pos<2> max = {window->width(), window->height()};
-    const Box<2> base(min, max);
-    world->spawn<Block<2>>(Pos<2>::zero, base, bulwark);
-}
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
 
-} // namespace nvl
+#include "nvl/App.h"
+#include "nvl/ui/RayWindow.h"
+#include "nvl/ui/Recording.h"
 
 using nvl::RayWindow;
-using nvl::ToolBelt;
+using nvl::Recording;
 using nvl::Window;
 using nvl::World;
 
-int main() {
+int main(const int argc, const char **argv) {
+    std::string record_path;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else {
+            std::cerr << "Usage: app [--record PATH]" << std::endl;
+            return 1;
+        }
+    }
+
     RayWindow window("App", {1000, 1000});
     window.set_mouse_mode(Window::MouseMode::kViewport);
-    World<2>::Params params;
-    params.maximum_y = 1000;
-    params.gravity_accel = 2;
-    auto *world = window.open<World<2>>(params);
-    init_world(&window, world);
+    auto *world = nvl::open_app(&window);
 
-    window.open<ToolBelt<2>>(world);
+    // Record the seed and input of this session so that it can be replayed headless (see nvl-bench --replay)
+    Recording recording;
+    recording.seed = world->random.seed();
+    recording.shape = {window.width(), window.height()};
+    if (!record_path.empty()) {
+        window.record(&recording);
+    }
 
     using Clock = std::chrono::steady_clock;
     std::chrono::time_point<std::chrono::steady_clock> prev_tick = Clock::now();
@@ -42,4 +47,9 @@ int main() {
         window.feed();
         window.draw();
     }
+
+    if (!record_path.empty() && !recording.save(record_path)) {
+        std::cerr << "Unable to write recording to " << record_path << std::endl;
+        return 1;
+    }
 }
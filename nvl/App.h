@@ -0,0 +1,36 @@
+#pragma once
+
+#include "nvl/entity/Block.h"
+#include "nvl/material/Bulwark.h"
+#include "nvl/tool/ToolBelt.h"
+#include "nvl/ui/Window.h"
+#include "nvl/world/World.h"
+
+namespace nvl {
+
+/// Returns the parameters of the interactive app's world, seeded with `seed` (0 seeds from the OS).
+inline World<2>::Params app_params(const U64 seed = 0) {
+    World<2>::Params params;
+    params.maximum_y = 1000;
+    params.gravity_accel = 2;
+    params.seed = seed;
+    return params;
+}
+
+inline void init_world(Window *window, World<2> *world) {
+    const Material bulwark = Material::get<Bulwark>();
+    const Pos<2> min = {0, window->height() - 50};
+    const Pos<2> max = {window->width(), window->height()};
+    const Box<2> base(min, max);
+    world->spawn<Block<2>>(Pos<2>::zero, base, bulwark);
+}
+
+/// Opens the interactive app's world and tools in `window`, e.g. for replaying a recorded session.
+inline World<2> *open_app(Window *window, const U64 seed = 0) {
+    auto *world = window->open<World<2>>(app_params(seed));
+    init_world(window, world);
+    window->open<ToolBelt<2>>(world);
+    return world;
+}
+
+} // namespace nvl
@@ -3,6 +3,7 @@
 #include "nvl/actor/Status.h"
 #include "nvl/data/List.h"
 #include "nvl/data/SipHash.h"
+#include "nvl/data/SlotMap.h"
 #include "nvl/ui/Color.h"
 #include "nvl/macros/Abstract.h"
 #include "nvl/macros/Aliases.h"
@@ -19,18 +20,43 @@ abstract struct AbstractActor : Castable<Actor, AbstractActor>::BaseClass {
     class_tag(AbstractActor);
     virtual Status tick(const List<Message> &messages) = 0;
     virtual void draw(Window *window, const Color::Options &options) const = 0;
+
+    /// Returns the generational id assigned by the world which owns this actor, if any.
+    pure const SlotId &id() const { return id_; }
+    void set_id(const SlotId &id) { id_ = id; }
+
+private:
+    SlotId id_;
 };
 
+/**
+ * @struct Actor
+ * @brief Handle to an actor, pairing a pointer to it with its generational id.
+ *
+ * Handles to actors owned by a world can be checked for staleness using only the id (e.g. see SlotMap::has), and are
+ * hashed by id. Actors without an id (not owned by a world) fall back to hashing by pointer.
+ */
 struct Actor final : Castable<Actor, AbstractActor> {
-    using Castable::Castable;
     using Castable::get;
-    pure bool operator==(const Actor &rhs) const { return ptr() == rhs.ptr(); }
-    pure bool operator!=(const Actor &rhs) const { return ptr() != rhs.ptr(); }
+
+    Actor() = default;
+    implicit Actor(nullptr_t) : Castable(nullptr) {}
+    explicit Actor(AbstractActor *ptr) : Castable(ptr), id_(ptr ? ptr->id() : SlotId()) {}
+
+    pure const SlotId &id() const { return id_; }
+
+    pure bool operator==(const Actor &rhs) const { return ptr() == rhs.ptr() && id_ == rhs.id_; }
+    pure bool operator!=(const Actor &rhs) const { return !(*this == rhs); }
+
+private:
+    SlotId id_;
 };
 
 } // namespace nvl
 
 template <>
 struct std::hash<nvl::Actor> {
-    pure U64 operator()(const nvl::Actor &actor) const noexcept { return sip_hash(actor.ptr()); }
+    pure U64 operator()(const nvl::Actor &actor) const noexcept {
+        return actor.id().valid() ? actor.id().bits() : sip_hash(actor.ptr());
+    }
 };
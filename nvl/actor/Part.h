@@ -1,30 +1,54 @@
 #pragma once
 
+#include <utility>
+
+#include "nvl/data/StaticList.h"
 #include "nvl/geo/Box.h"
 #include "nvl/macros/Aliases.h"
 #include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
 #include "nvl/material/Material.h"
 
 namespace nvl {
 
-template <U64 N>
+/**
+ * @class Part
+ * @brief A box of a single material, making up part of an entity.
+ *
+ * Parts are positioned with the same coordinates as the boxes their entities are spawned with, which may span the
+ * whole world, so they are stored with 64-bit coordinates by default. A compact `T` such as I32 can be chosen where
+ * coordinates are known to fit. The box is widened to 64-bit coordinates in `bbox`, so indexes and geometry are
+ * unaffected.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ * @tparam T Type of each stored coordinate. Defaults to I64.
+ */
+template <U64 N, typename T = I64>
 class Part {
 public:
-    explicit Part(const Box<N> &box, Material material, const I64 health)
-        : box(box), material(std::move(material)), health(health) {}
-    explicit Part(const Box<N> &box, const Material &material) : Part(box, material, material->durability) {}
+    explicit Part(const Box<N> &box, const Material material, const I64 health)
+        : box(box), material(material), health(health) {}
+    explicit Part(const Box<N> &box, const Material material) : Part(box, material, material->durability) {}
+
+    /// Returns true if every coordinate of `box` can be stored in a Part with coordinates of type `T`.
+    pure static bool fits(const Box<N> &box) {
+        for (U64 i = 0; i < N; ++i) {
+            return_if(!std::in_range<T>(box.min[i]) || !std::in_range<T>(box.max[i]), false);
+        }
+        return true;
+    }
 
-    pure const Box<N> &bbox() const { return box; }
+    pure Box<N> bbox() const { return Box<N>(box); }
 
-    pure List<Part> diff(const Box<N> &rhs) const {
-        List<Part> result;
-        for (const Box<N> &rest : box.diff(rhs)) {
+    pure StaticList<Part, 2 * N> diff(const Box<N> &rhs) const {
+        StaticList<Part, 2 * N> result;
+        for (const Box<N> &rest : bbox().diff(rhs)) {
             result.emplace_back(rest, material, health);
         }
         return result;
     }
 
-    Box<N> box;
+    Box<N, T> box;
     Material material;
     I64 health;
 };
@@ -0,0 +1,283 @@
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "nvl/App.h"
+#include "nvl/bench/Scenario.h"
+#include "nvl/test/NullWindow.h"
+#include "nvl/time/Duration.h"
+#include "nvl/time/Profiler.h"
+#include "nvl/ui/Recording.h"
+#include "nvl/world/World.h"
+
+namespace nvl::bench {
+
+struct Options {
+    std::string_view scenario = "tower";
+    U64 dims = 2;
+    U64 ticks = 1000;
+    U64 size = 16;
+    U64 seed = 0xDEADBEEF;
+    bool json = false;
+    std::string_view profile_csv = ""; // Per-tick profile output, if non-empty (requires NVL_PROFILE)
+    std::string_view replay = "";      // Recorded session to replay instead of running a scenario, if non-empty
+    std::string_view index = "tree";   // Spatial index of entities: tree, hash, or all to compare both
+};
+
+struct Result {
+    U64 setup = 0;    // ns
+    U64 total = 0;    // ns
+    U64 min_tick = 0; // ns
+    U64 max_tick = 0; // ns
+    U64 p99_tick = 0; // ns
+    U64 ticks = 0;
+    U64 max_awake = 0;
+    U64 final_awake = 0;
+    U64 final_alive = 0;
+    U64 settled_tick = 0;
+
+    pure F64 ticks_per_sec() const { return ticks * 1e9 / std::max<F64>(total, 1); }
+};
+
+/// Times each call to `tick` until it returns false, summarizing the tick times and the state of `world` in `result`.
+template <U64 N, typename Tick>
+void measure(Result &result, const World<N> &world, Tick &&tick) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<U64> times;
+    while (true) {
+        const auto start = Clock::now();
+        if (!tick()) {
+            break;
+        }
+        const auto end = Clock::now();
+        times.push_back(Duration(end - start).nanos());
+        result.max_awake = std::max(result.max_awake, world.num_awake());
+        if (world.num_awake() == 0 && result.settled_tick == 0) {
+            result.settled_tick = times.size();
+        }
+    }
+
+    U64 total = 0;
+    for (const U64 time : times) {
+        total += time;
+    }
+    std::sort(times.begin(), times.end());
+    result.ticks = times.size();
+    result.total = total;
+    if (!times.empty()) {
+        result.min_tick = times.front();
+        result.max_tick = times.back();
+        result.p99_tick = times[(times.size() - 1) * 99 / 100];
+    }
+    result.final_awake = world.num_awake();
+    result.final_alive = world.num_alive();
+}
+
+template <U64 N>
+Result run(const Options &options, const typename Scenario<N>::Kind kind) {
+    using Clock = std::chrono::steady_clock;
+    test::NullWindow window;
+    typename World<N>::Params params;
+    params.index = options.index == "hash" ? World<N>::IndexKind::kHashGrid : World<N>::IndexKind::kTree;
+    World<N> world(&window, params);
+    world.set_hud(false);
+
+    Result result;
+    Scenario<N> scenario(kind, options.size, options.seed);
+    const auto setup_start = Clock::now();
+    scenario.init(world);
+    result.setup = Duration(Clock::now() - setup_start).nanos();
+    Profiler::global().reset();
+
+    U64 ticks = 0;
+    measure(result, world, [&] {
+        return_if(ticks++ == options.ticks, false);
+        scenario.step(world);
+        world.tick();
+        return true;
+    });
+    return result;
+}
+
+/// Replays a session recorded by the app (see `app --record`) headless, as fast as possible.
+Result replay(const Recording &recording) {
+    using Clock = std::chrono::steady_clock;
+    test::NullWindow window("replay", recording.shape);
+    Result result;
+    const auto setup_start = Clock::now();
+    World<2> *world = open_app(&window, recording.seed);
+    world->set_hud(false);
+    result.setup = Duration(Clock::now() - setup_start).nanos();
+    Profiler::global().reset();
+
+    Replayer replayer(recording, &window);
+    measure(result, *world, [&] { return replayer.step(); });
+    return result;
+}
+
+void report(std::ostream &os, const Options &options, const Result &result) {
+    if (options.json) {
+        os << "{\"scenario\": \"" << options.scenario << "\", \"index\": \"" << options.index
+           << "\", \"dims\": " << options.dims
+           << ", \"size\": " << options.size << ", \"seed\": " << options.seed << ", \"ticks\": " << result.ticks
+           << ", \"setup_ns\": " << result.setup << ", \"total_ns\": " << result.total
+           << ", \"ticks_per_sec\": " << result.ticks_per_sec() << ", \"min_tick_ns\": " << result.min_tick
+           << ", \"p99_tick_ns\": " << result.p99_tick << ", \"max_tick_ns\": " << result.max_tick
+           << ", \"max_awake\": " << result.max_awake << ", \"final_awake\": " << result.final_awake
+           << ", \"final_alive\": " << result.final_alive << ", \"settled_tick\": " << result.settled_tick;
+        if constexpr (Profiler::kEnabled) {
+            os << ", \"profile\": ";
+            Profiler::global().write_json(os);
+        }
+        os << "}" << std::endl;
+        return;
+    }
+    os << "[" << options.scenario << " " << options.dims << "D, size " << options.size << ", seed " << options.seed
+       << ", " << options.index << " index]" << std::endl;
+    os << "  Setup:        " << Duration(result.setup) << std::endl;
+    os << "  Ticks:        " << result.ticks << " in " << Duration(result.total) << " (" << result.ticks_per_sec()
+       << " ticks/sec)" << std::endl;
+    os << "  Tick time:    min " << Duration(result.min_tick) << ", avg "
+       << Duration(result.total / std::max<U64>(result.ticks, 1)) << ", p99 " << Duration(result.p99_tick) << ", max "
+       << Duration(result.max_tick) << std::endl;
+    os << "  Awake:        " << result.final_awake << " (max " << result.max_awake << ")" << std::endl;
+    os << "  Alive:        " << result.final_alive << std::endl;
+    if (result.settled_tick > 0) {
+        os << "  Settled at:   tick " << result.settled_tick << std::endl;
+    }
+    if constexpr (Profiler::kEnabled) {
+        const Profiler &profiler = Profiler::global();
+        os << "  Profile (last " << std::min(profiler.frames(), Profiler::kHistory) << " ticks, per tick):" << std::endl;
+        for (Profiler::Id id = 0; id < profiler.metrics().size(); ++id) {
+            const Profiler::Metric &metric = profiler.metric(id);
+            const Profiler::Summary summary = profiler.summary(id);
+            os << "    " << metric.name << ": ";
+            if (metric.kind == Profiler::Kind::kTimer) {
+                os << "mean " << Duration(summary.mean) << ", p99 " << Duration(summary.p99) << ", max "
+                   << Duration(summary.max);
+            } else {
+                os << "mean " << summary.mean << ", p99 " << summary.p99 << ", max " << summary.max;
+            }
+            os << " (" << summary.calls << " calls)" << std::endl;
+        }
+    }
+}
+
+/// Writes the profile of the last run as CSV to `path`, if non-empty. The index is added to the file name when
+/// comparing all indices, e.g. "profile.hash.csv" for "profile.csv", so that each run gets its own file.
+void write_profile(const Options &options, const std::string_view index = "") {
+    return_if(options.profile_csv.empty());
+    std::filesystem::path path(options.profile_csv);
+    if (!index.empty()) {
+        path.replace_extension(std::string(index) + path.extension().string());
+    }
+    std::ofstream file(path);
+    Profiler::global().write_csv(file);
+}
+
+template <U64 N>
+int run_and_report(const Options &options) {
+    const Maybe<typename Scenario<N>::Kind> kind = Scenario<N>::parse(options.scenario);
+    if (!kind.has_value()) {
+        std::cerr << "Unknown scenario: " << options.scenario << std::endl;
+        return 1;
+    }
+    if (options.index == "all") {
+        // Runs the scenario with each index in turn, so that they can be compared directly
+        for (const std::string_view index : {"tree", "hash"}) {
+            Options each = options;
+            each.index = index;
+            report(std::cout, each, run<N>(each, *kind));
+            write_profile(each, index);
+        }
+        return 0;
+    }
+    report(std::cout, options, run<N>(options, *kind));
+    write_profile(options);
+    return 0;
+}
+
+int replay_and_report(Options options) {
+    const Maybe<Recording> recording = Recording::load(std::string(options.replay));
+    if (!recording.has_value()) {
+        std::cerr << "Unable to read recording: " << options.replay << std::endl;
+        return 1;
+    }
+    options.scenario = "replay";
+    options.seed = recording->seed;
+    report(std::cout, options, replay(*recording));
+    write_profile(options);
+    return 0;
+}
+
+/// Parses all of `text` as an unsigned integer into `value`. Returns false if it is not one.
+bool parse(const std::string_view text, U64 &value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+void usage() {
+    std::cerr << "Usage: nvl-bench [--scenario tower|rubble|rain|storm] [--dims 2|3] [--ticks N] [--size N] "
+                 "[--seed N] [--index tree|hash|all] [--json] [--profile-csv PATH] [--replay PATH]"
+              << std::endl;
+    std::cerr << "  --replay always uses the tree index, so it cannot be combined with another --index." << std::endl;
+}
+
+} // namespace nvl::bench
+
+using nvl::bench::Options;
+
+int main(const int argc, const char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--scenario" && has_value) {
+            options.scenario = argv[++i];
+        } else if (arg == "--dims" && has_value && nvl::bench::parse(argv[i + 1], options.dims)) {
+            ++i;
+        } else if (arg == "--ticks" && has_value && nvl::bench::parse(argv[i + 1], options.ticks)) {
+            ++i;
+        } else if (arg == "--size" && has_value && nvl::bench::parse(argv[i + 1], options.size)) {
+            ++i;
+        } else if (arg == "--seed" && has_value && nvl::bench::parse(argv[i + 1], options.seed)) {
+            ++i;
+        } else if (arg == "--profile-csv" && has_value) {
+            options.profile_csv = argv[++i];
+        } else if (arg == "--replay" && has_value) {
+            options.replay = argv[++i];
+        } else if (arg == "--index" && has_value) {
+            options.index = argv[++i];
+        } else {
+            nvl::bench::usage();
+            return 1;
+        }
+    }
+    if (options.index != "tree" && options.index != "hash" && options.index != "all") {
+        nvl::bench::usage();
+        return 1;
+    }
+    if (!options.replay.empty()) {
+        // Replays use the app's world, which always uses the default index
+        if (options.index != "tree") {
+            nvl::bench::usage();
+            return 1;
+        }
+        return nvl::bench::replay_and_report(options);
+    }
+    if (options.dims == 2) {
+        return nvl::bench::run_and_report<2>(options);
+    } else if (options.dims == 3) {
+        return nvl::bench::run_and_report<3>(options);
+    }
+    nvl::bench::usage();
+    return 1;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <random>
+
+#include "nvl/data/List.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/math/Random.h"
+
+namespace nvl::bench {
+
+/// Returns a random position with each coordinate drawn uniformly from [min, max].
+template <U64 N>
+pure Pos<N> random_pos(Random &random, const I64 min, const I64 max) {
+    std::uniform_int_distribution<I64> distribution(min, max);
+    Pos<N> pos;
+    for (U64 i = 0; i < N; ++i) {
+        pos[i] = distribution(random.engine());
+    }
+    return pos;
+}
+
+/// Returns `count` random boxes with minimums in [0, extent) and shapes in [1, max_shape] along each dimension.
+template <U64 N>
+pure List<Box<N>> random_boxes(Random &random, const U64 count, const I64 extent, const I64 max_shape) {
+    List<Box<N>> boxes;
+    for (U64 i = 0; i < count; ++i) {
+        const Pos<N> min = random_pos<N>(random, 0, extent - 1);
+        boxes.emplace_back(min, min + random_pos<N>(random, 0, max_shape - 1));
+    }
+    return boxes;
+}
+
+} // namespace nvl::bench
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <string_view>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Maybe.h"
+#include "nvl/entity/Block.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/material/Bulwark.h"
+#include "nvl/material/Material.h"
+#include "nvl/material/TestMaterial.h"
+#include "nvl/math/Random.h"
+#include "nvl/message/Hit.h"
+#include "nvl/world/World.h"
+
+namespace nvl::bench {
+
+/**
+ * @class Scenario
+ * @brief Reproducible workload for headless simulation benchmarks.
+ *
+ * Scenarios populate a World with a floor plus some arrangement of falling blocks, and optionally inject more work
+ * (new blocks or Hit messages) every tick. All randomness is drawn from a Random seeded by the caller, so the same
+ * (kind, size, seed) always produces the same world.
+ *
+ * @tparam N Number of dimensions in the simulated world.
+ */
+template <U64 N>
+class Scenario {
+public:
+    enum Kind {
+        kTower,  // Columns of stacked blocks which settle onto the floor
+        kRubble, // Randomly sized blocks scattered above the floor
+        kRain,   // Blocks continuously spawned above the floor
+        kStorm   // Resting blocks which are hit every tick
+    };
+    static constexpr std::string_view kNames[] = {"tower", "rubble", "rain", "storm"};
+
+    static constexpr I64 kBlockSize = 16; // pixels
+    static constexpr I64 kFloorHeight = 32; // pixels
+
+    static Maybe<Kind> parse(const std::string_view name) {
+        for (U64 i = 0; i < std::size(kNames); ++i) {
+            return_if(kNames[i] == name, static_cast<Kind>(i));
+        }
+        return None;
+    }
+
+    /// Creates a scenario of the given `kind` where `size` controls the amount of work (e.g. number of columns).
+    explicit Scenario(const Kind kind, const U64 size, const U64 seed)
+        : kind_(kind), size_(size), random_(seed), width_(static_cast<I64>(size) * kBlockSize * 4),
+          floor_y_(static_cast<I64>(size) * kBlockSize * 4) {
+        bulwark_ = Material::get<Bulwark>();
+        for (U64 i = 0; i < kNumMaterials; ++i) {
+            materials_.push_back(Material::get<TestMaterial>(random_.uniform<Color>(0, 255)));
+        }
+    }
+
+    pure Kind kind() const { return kind_; }
+    pure std::string_view name() const { return kNames[kind_]; }
+
+    /// Populates the world with the initial state of this scenario.
+    void init(World<N> &world) {
+        world.template spawn<Block<N>>(Pos<N>::zero, make_box(0, floor_y_, width_ - 1, floor_y_ + kFloorHeight - 1), bulwark_);
+        switch (kind_) {
+        case kTower:
+            init_towers(world);
+            break;
+        case kRubble:
+            init_rubble(world, floor_y_ / 2);
+            break;
+        case kRain:
+            break;
+        case kStorm:
+            init_stacked(world);
+            break;
+        }
+    }
+
+    /// Injects any additional per-tick work into the world.
+    void step(World<N> &world) {
+        if (kind_ == kRain) {
+            for (U64 i = 0; i < size_ / 4 + 1; ++i) {
+                const I64 x = random_.uniform<I64, I64>(0, width_ / kBlockSize - 1) * kBlockSize;
+                const Box<N> box = make_box(x, 0, x + kBlockSize - 1, kBlockSize - 1);
+                if (world.entities(box).empty()) {
+                    world.template spawn<Block<N>>(Pos<N>::zero, box, next_material());
+                }
+            }
+        } else if (kind_ == kStorm) {
+            for (U64 i = 0; i < size_; ++i) {
+                const I64 x = random_.uniform<I64, I64>(0, width_ - 1);
+                const I64 y = random_.uniform<I64, I64>(floor_y_ / 2, floor_y_ - 1);
+                const Box<N> box = make_box(x, y, x + kBlockSize / 2, y + kBlockSize / 2);
+                world.template send<Hit<N>>(nullptr, world.entities(box), box, /*strength*/ 1);
+            }
+        }
+    }
+
+private:
+    static constexpr U64 kNumMaterials = 8;
+
+    /// Returns a box spanning [x0, x1] horizontally and [y0, y1] vertically, with one block of depth in higher dims.
+    static Box<N> make_box(const I64 x0, const I64 y0, const I64 x1, const I64 y1) {
+        Pos<N> min = Pos<N>::zero;
+        Pos<N> max = Pos<N>::fill(kBlockSize - 1);
+        min[0] = x0;
+        max[0] = x1;
+        min[World<N>::kVerticalDim] = y0;
+        max[World<N>::kVerticalDim] = y1;
+        return Box<N>(min, max);
+    }
+
+    Material next_material() { return materials_[random_.uniform<U64, U64>(0, kNumMaterials - 1)]; }
+
+    void init_towers(World<N> &world) {
+        // Columns of blocks separated by a one pixel gap so that every block falls a short distance before resting.
+        const I64 height = static_cast<I64>(size_);
+        for (I64 col = 0; col < static_cast<I64>(size_); ++col) {
+            const I64 x = col * kBlockSize * 4;
+            for (I64 row = 0; row < height; ++row) {
+                const I64 y1 = floor_y_ - 2 - row * (kBlockSize + 1);
+                world.template spawn<Block<N>>(Pos<N>::zero, make_box(x, y1 - kBlockSize + 1, x + kBlockSize - 1, y1),
+                                               next_material());
+            }
+        }
+    }
+
+    void init_rubble(World<N> &world, const I64 max_y) {
+        // Randomly sized blocks, one per grid cell, so that no two blocks start out overlapping.
+        for (I64 y = 0; y + kBlockSize <= max_y; y += kBlockSize) {
+            for (I64 x = 0; x + kBlockSize <= width_; x += kBlockSize) {
+                if (random_.uniform<I64, I64>(0, 3) == 0) {
+                    const I64 w = random_.uniform<I64, I64>(1, kBlockSize - 1);
+                    const I64 h = random_.uniform<I64, I64>(1, kBlockSize - 1);
+                    world.template spawn<Block<N>>(Pos<N>::zero, make_box(x, y, x + w - 1, y + h - 1), next_material());
+                }
+            }
+        }
+    }
+
+    void init_stacked(World<N> &world) {
+        // Densely packed blocks which start out resting on each other and the floor.
+        for (I64 y = floor_y_ - kBlockSize; y >= floor_y_ / 2; y -= kBlockSize) {
+            for (I64 x = 0; x + kBlockSize <= width_; x += kBlockSize) {
+                world.template spawn<Block<N>>(Pos<N>::zero, make_box(x, y, x + kBlockSize - 1, y + kBlockSize - 1),
+                                               next_material());
+            }
+        }
+    }
+
+    Kind kind_;
+    U64 size_;
+    Random random_;
+    I64 width_;
+    I64 floor_y_;
+    Material bulwark_;
+    List<Material> materials_;
+};
+
+} // namespace nvl::bench
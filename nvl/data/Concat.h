@@ -0,0 +1,54 @@
+#pragma once
+
+#include "nvl/data/Iterator.h"
+#include "nvl/data/Range.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @struct concat_iterator
+ * @brief Iterates over all values of a first range, followed by all values of a second range.
+ */
+template <typename Value>
+struct concat_iterator final : AbstractIteratorCRTP<concat_iterator<Value>, Value> {
+    class_tag(concat_iterator<Value>, AbstractIterator<Value>);
+
+    template <View Type = View::kImmutable>
+    pure static Iterator<Value, Type> begin(const Range<Value> &a, const Range<Value> &b) {
+        return make_iterator<concat_iterator, Type>(a.begin(), a.end(), b.begin());
+    }
+    template <View Type = View::kImmutable>
+    pure static Iterator<Value, Type> end(const Range<Value> &a, const Range<Value> &b) {
+        return make_iterator<concat_iterator, Type>(a.end(), a.end(), b.end());
+    }
+
+    concat_iterator(Iterator<Value> a, Iterator<Value> a_end, Iterator<Value> b) : a(a), a_end(a_end), b(b) {}
+
+    // Iterators share their underlying state when copied, so copies must advance independently
+    concat_iterator(const concat_iterator &rhs) : a(rhs.a.copy()), a_end(rhs.a_end), b(rhs.b.copy()) {}
+
+    void increment() override {
+        if (a != a_end) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+
+    pure const Value *ptr() override { return (a != a_end) ? &*a : &*b; }
+
+    pure bool operator==(const concat_iterator &rhs) const override { return a == rhs.a && b == rhs.b; }
+
+    Iterator<Value> a;
+    Iterator<Value> a_end;
+    Iterator<Value> b;
+};
+
+/// Returns a range over all values in `a` followed by all values in `b`.
+template <typename Value>
+pure Range<Value> concat(const Range<Value> &a, const Range<Value> &b) {
+    return make_range<concat_iterator<Value>>(a, b);
+}
+
+} // namespace nvl
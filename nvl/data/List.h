@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "nvl/data/Iterator.h"
@@ -71,6 +72,13 @@ public:
         return *this;
     }
 
+    /// Sorts the values in place, ordered by `compare`.
+    template <typename Compare>
+    List<Value> &sort(Compare compare) {
+        std::sort(parent::begin(), parent::end(), compare);
+        return *this;
+    }
+
     void clear() { parent::clear(); }
 
 private:
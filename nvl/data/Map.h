@@ -66,6 +66,29 @@ public:
         }
     };
 
+    struct kiterator final : AbstractIteratorCRTP<kiterator, K>, parent::const_iterator {
+        class_tag(Map::kiterator, AbstractIterator<K>);
+        using value_type = K;
+
+        template <View Type = View::kImmutable>
+        static Iterator<K, Type> begin(const Map &map) {
+            return make_iterator<kiterator, Type>(map._begin());
+        }
+        template <View Type = View::kImmutable>
+        static Iterator<K, Type> end(const Map &map) {
+            return make_iterator<kiterator, Type>(map._end());
+        }
+
+        explicit kiterator(typename parent::const_iterator iter) : parent::const_iterator(iter) {}
+
+        void increment() override { parent::const_iterator::operator++(); }
+        const K *ptr() override { return &parent::const_iterator::operator->()->first; }
+
+        pure bool operator==(const kiterator &rhs) const override {
+            return *static_cast<const typename parent::const_iterator *>(this) == rhs;
+        }
+    };
+
     Map() : parent() {}
     Map(std::initializer_list<std::pair<const K, V>> init) : parent(init) {}
 
@@ -157,6 +180,8 @@ public:
     pure Iterator<Entry> begin() const { return entry_iterator::template begin(*this); }
     pure Iterator<Entry> end() const { return entry_iterator::template end(*this); }
 
+    pure Range<K> keys() const { return {kiterator::template begin(*this), kiterator::template end(*this)}; }
+
     pure MRange<V> values() { return {values_begin(), values_end()}; }
     pure Range<V> values() const { return {values_begin(), values_end()}; }
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+
+#include "nvl/data/Iterator.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Range.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @struct shared_iterator
+ * @brief Iterates over a list which is owned jointly by all iterators over it, e.g. the results of a query which
+ * were collected up front but are returned as a Range.
+ */
+template <typename Value>
+struct shared_iterator final : AbstractIteratorCRTP<shared_iterator<Value>, Value> {
+    class_tag(shared_iterator<Value>, AbstractIterator<Value>);
+
+    template <View Type = View::kImmutable>
+    pure static Iterator<Value, Type> begin(const std::shared_ptr<const List<Value>> &list) {
+        return make_iterator<shared_iterator, Type>(list);
+    }
+    template <View Type = View::kImmutable>
+    pure static Iterator<Value, Type> end(const std::shared_ptr<const List<Value>> &) {
+        return make_iterator<shared_iterator, Type>(nullptr);
+    }
+
+    explicit shared_iterator(std::shared_ptr<const List<Value>> list) : list(std::move(list)) {}
+
+    void increment() override { ++index; }
+
+    pure const Value *ptr() override { return &(*list)[index]; }
+
+    pure bool operator==(const shared_iterator &rhs) const override {
+        return done() ? rhs.done() : list == rhs.list && index == rhs.index;
+    }
+
+    pure bool done() const { return list == nullptr || index >= list->size(); }
+
+    std::shared_ptr<const List<Value>> list;
+    U64 index = 0;
+};
+
+/// Returns a range over the values in `list`, which is kept alive for as long as the range or any of its iterators.
+template <typename Value, View Type = View::kImmutable>
+pure Range<Value, Type> shared(List<Value> list) {
+    return make_range<shared_iterator<Value>, Type>(std::make_shared<const List<Value>>(std::move(list)));
+}
+
+} // namespace nvl
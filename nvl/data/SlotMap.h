@@ -0,0 +1,129 @@
+#pragma once
+
+#include <limits>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Range.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+/**
+ * @struct SlotId
+ * @brief Generational index of a value in a SlotMap.
+ *
+ * Slots are reused after their value is removed, but with a new generation, so ids of removed values never compare
+ * equal to ids of values inserted later and can be detected as stale without dereferencing anything.
+ */
+struct SlotId {
+    static constexpr U32 kInvalid = std::numeric_limits<U32>::max();
+
+    U32 index = kInvalid;
+    U32 generation = 0;
+
+    pure bool valid() const { return index != kInvalid; }
+
+    /// Returns the index and generation packed into a single integer, e.g. for hashing.
+    pure U64 bits() const { return (static_cast<U64>(generation) << 32) | index; }
+
+    pure bool operator==(const SlotId &rhs) const { return index == rhs.index && generation == rhs.generation; }
+    pure bool operator!=(const SlotId &rhs) const { return !(*this == rhs); }
+};
+
+inline std::ostream &operator<<(std::ostream &os, const SlotId &id) {
+    return os << "#" << id.index << "." << id.generation;
+}
+
+/**
+ * @class SlotMap
+ * @brief Stores values densely, addressed by generational ids which stay stable across removals.
+ *
+ * Insertion, removal, and lookup are all O(1). Removal moves the last value into the removed value's place, so
+ * iteration order is not stable, but iteration is always a linear scan over contiguous memory.
+ *
+ * @tparam T Value type.
+ */
+template <typename T>
+class SlotMap {
+public:
+    /// Inserts `value`, returning its id.
+    SlotId insert(T value) {
+        U32 index;
+        if (free_.empty()) {
+            index = slots_.size();
+            slots_.push_back({});
+        } else {
+            index = free_.back();
+            free_.pop_back();
+        }
+        Slot &slot = slots_[index];
+        slot.dense = values_.size();
+        values_.push_back(std::move(value));
+        indices_.push_back(index);
+        return {index, slot.generation};
+    }
+
+    /// Removes the value with the given id. Returns false if the id is stale.
+    bool remove(const SlotId &id) {
+        return_if(!has(id), false);
+        Slot &slot = slots_[id.index];
+        const U32 last = values_.size() - 1;
+        if (slot.dense != last) {
+            values_[slot.dense] = std::move(values_[last]);
+            indices_[slot.dense] = indices_[last];
+            slots_[indices_[last]].dense = slot.dense;
+        }
+        values_.pop_back();
+        indices_.pop_back();
+        slot.dense = SlotId::kInvalid;
+        slot.generation += 1;
+        free_.push_back(id.index);
+        return true;
+    }
+
+    /// Returns true if `id` refers to a value which has not been removed.
+    pure bool has(const SlotId &id) const {
+        return id.index < slots_.size() && slots_[id.index].generation == id.generation &&
+               slots_[id.index].dense != SlotId::kInvalid;
+    }
+
+    /// Returns a pointer to the value with the given id, or nullptr if the id is stale.
+    pure T *get(const SlotId &id) { return has(id) ? &values_[slots_[id.index].dense] : nullptr; }
+    pure const T *get(const SlotId &id) const { return has(id) ? &values_[slots_[id.index].dense] : nullptr; }
+
+    /// Returns the id of the i-th value in iteration order.
+    pure SlotId id_at(const U64 i) const { return {indices_[i], slots_[indices_[i]].generation}; }
+
+    pure U64 size() const { return values_.size(); }
+    pure bool empty() const { return values_.empty(); }
+
+    pure Range<T> values() const { return values_.range(); }
+    pure Iterator<T> begin() const { return values_.begin(); }
+    pure Iterator<T> end() const { return values_.end(); }
+
+    /// Removes all values. Ids of removed values remain stale.
+    void clear() {
+        for (const U32 index : indices_) {
+            slots_[index].dense = SlotId::kInvalid;
+            slots_[index].generation += 1;
+            free_.push_back(index);
+        }
+        values_.clear();
+        indices_.clear();
+    }
+
+private:
+    struct Slot {
+        U32 generation = 0;
+        U32 dense = SlotId::kInvalid; // Index into values_, or kInvalid if this slot is free
+    };
+
+    List<T> values_;   // Dense values
+    List<U32> indices_; // Slot index of each dense value
+    List<Slot> slots_;
+    List<U32> free_; // Free slot indices
+};
+
+} // namespace nvl
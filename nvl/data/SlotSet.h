@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Range.h"
+#include "nvl/data/SlotMap.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+/**
+ * @class SlotSet
+ * @brief Set of values which have generational ids (e.g. from a SlotMap), stored densely.
+ *
+ * Membership is tracked by a sparse array indexed by each value's slot index, so insertion, removal, and lookup are
+ * all O(1) without hashing, and iteration is a linear scan. Removal does not preserve iteration order.
+ *
+ * @tparam T Value type, which must have an `id()` method returning its SlotId.
+ */
+template <typename T>
+class SlotSet {
+public:
+    /// Inserts `value`. Returns false if it was already present.
+    bool insert(const T &value) {
+        const SlotId id = value.id();
+        return_if(has(id), false);
+        if (id.index >= positions_.size()) {
+            positions_.resize(id.index + 1, SlotId::kInvalid);
+        }
+        positions_[id.index] = values_.size();
+        values_.push_back(value);
+        return true;
+    }
+
+    /// Removes `value`. Returns false if it was not present.
+    bool remove(const T &value) {
+        const SlotId id = value.id();
+        return_if(!has(id), false);
+        const U32 pos = positions_[id.index];
+        const U32 last = values_.size() - 1;
+        if (pos != last) {
+            values_[pos] = values_[last];
+            positions_[values_[pos].id().index] = pos;
+        }
+        values_.pop_back();
+        positions_[id.index] = SlotId::kInvalid;
+        return true;
+    }
+
+    void remove(const Range<T> &values) {
+        for (const T &value : values) {
+            remove(value);
+        }
+    }
+
+    pure bool has(const T &value) const { return has(value.id()); }
+
+    /// Returns true if the set contains a value with exactly this id (including its generation).
+    pure bool has(const SlotId &id) const {
+        return id.index < positions_.size() && positions_[id.index] != SlotId::kInvalid &&
+               values_[positions_[id.index]].id() == id;
+    }
+
+    pure U64 size() const { return values_.size(); }
+    pure bool empty() const { return values_.empty(); }
+
+    pure Range<T> values() const { return values_.range(); }
+    pure Iterator<T> begin() const { return values_.begin(); }
+    pure Iterator<T> end() const { return values_.end(); }
+
+    void clear() {
+        for (const T &value : values_) {
+            positions_[value.id().index] = SlotId::kInvalid;
+        }
+        values_.clear();
+    }
+
+private:
+    List<T> values_;
+    std::vector<U32> positions_; // Slot index => index into values_, or kInvalid if absent
+};
+
+} // namespace nvl
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Assert.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+/**
+ * @class StaticList
+ * @brief List with a fixed capacity, stored inline, so it never allocates.
+ *
+ * Suits small results with a known bound, such as the at most 2N remainders of Box::diff. Iterators are plain
+ * pointers, so iterating is as cheap as for an array. Lists of trivially copyable values, such as Box and Edge, can be
+ * built in constant expressions.
+ *
+ * @tparam Value Value type being stored.
+ * @tparam kCapacity Maximum number of values.
+ */
+template <typename Value, U64 kCapacity>
+class StaticList {
+public:
+    using value_type = Value;
+    using iterator = Value *;
+    using const_iterator = const Value *;
+
+    constexpr StaticList() {}
+
+    constexpr StaticList(std::initializer_list<Value> values) {
+        for (const Value &value : values) {
+            push_back(value);
+        }
+    }
+
+    constexpr StaticList(const StaticList &rhs) {
+        for (const Value &value : rhs) {
+            push_back(value);
+        }
+    }
+
+    constexpr StaticList(StaticList &&rhs) noexcept {
+        for (Value &value : rhs) {
+            emplace_back(std::move(value));
+        }
+    }
+
+    constexpr StaticList &operator=(const StaticList &rhs) {
+        return_if(this == &rhs, *this);
+        clear();
+        for (const Value &value : rhs) {
+            push_back(value);
+        }
+        return *this;
+    }
+
+    constexpr StaticList &operator=(StaticList &&rhs) noexcept {
+        return_if(this == &rhs, *this);
+        clear();
+        for (Value &value : rhs) {
+            emplace_back(std::move(value));
+        }
+        return *this;
+    }
+
+    constexpr ~StaticList() { clear(); }
+
+    pure static constexpr U64 capacity() { return kCapacity; }
+
+    pure constexpr U64 size() const { return size_; }
+    pure constexpr bool empty() const { return size_ == 0; }
+
+    constexpr void push_back(const Value &value) {
+        ASSERT(size_ < kCapacity, "StaticList is full with capacity " << kCapacity);
+        if constexpr (kTrivial) {
+            storage_.values[size_] = value;
+        } else {
+            std::construct_at(storage_.values + size_, value);
+        }
+        size_ += 1;
+    }
+
+    template <typename... Args>
+    constexpr Value &emplace_back(Args &&...args) {
+        ASSERT(size_ < kCapacity, "StaticList is full with capacity " << kCapacity);
+        Value *value = storage_.values + size_;
+        if constexpr (kTrivial) {
+            *value = Value(std::forward<Args>(args)...);
+        } else {
+            std::construct_at(value, std::forward<Args>(args)...);
+        }
+        size_ += 1;
+        return *value;
+    }
+
+    constexpr void pop_back() {
+        ASSERT(size_ > 0, "Cannot pop from an empty StaticList");
+        size_ -= 1;
+        if constexpr (!kTrivial) {
+            std::destroy_at(storage_.values + size_);
+        }
+    }
+
+    constexpr void clear() {
+        if constexpr (!kTrivial) {
+            std::destroy(storage_.values, storage_.values + size_);
+        }
+        size_ = 0;
+    }
+
+    pure constexpr const Value &operator[](const U64 i) const {
+        ASSERT(i < size_, "Index " << i << " is out of bounds [0, " << size_ << ")");
+        return storage_.values[i];
+    }
+    pure constexpr Value &operator[](const U64 i) {
+        ASSERT(i < size_, "Index " << i << " is out of bounds [0, " << size_ << ")");
+        return storage_.values[i];
+    }
+
+    pure constexpr const Value &front() const { return (*this)[0]; }
+    pure constexpr const Value &back() const { return (*this)[size_ - 1]; }
+
+    pure constexpr iterator begin() { return storage_.values; }
+    pure constexpr iterator end() { return storage_.values + size_; }
+    pure constexpr const_iterator begin() const { return storage_.values; }
+    pure constexpr const_iterator end() const { return storage_.values + size_; }
+
+    pure constexpr bool operator==(const StaticList &rhs) const {
+        return_if(size_ != rhs.size_, false);
+        for (U64 i = 0; i < size_; ++i) {
+            if (!(storage_.values[i] == rhs.storage_.values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    pure constexpr bool operator!=(const StaticList &rhs) const { return !(*this == rhs); }
+
+private:
+    static constexpr bool kTrivial = std::is_trivially_copyable_v<Value> && std::is_default_constructible_v<Value>;
+
+    // Trivial values are kept in a value-initialized array, so every value is alive in constant expressions
+    struct TrivialStorage {
+        constexpr TrivialStorage() : values() {}
+        Value values[kCapacity];
+    };
+
+    // Other values are only constructed as they are added, so unused values are never constructed, copied or destroyed
+    struct UnionStorage {
+        constexpr UnionStorage() {}
+        constexpr ~UnionStorage() {}
+        union {
+            Value values[kCapacity];
+        };
+    };
+
+    std::conditional_t<kTrivial, TrivialStorage, UnionStorage> storage_;
+    U64 size_ = 0;
+};
+
+template <typename Value, U64 kCapacity>
+std::ostream &operator<<(std::ostream &os, const StaticList<Value, kCapacity> &list) {
+    os << "{";
+    for (U64 i = 0; i < list.size(); ++i) {
+        os << (i == 0 ? "" : ", ") << list[i];
+    }
+    return os << "}";
+}
+
+} // namespace nvl
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "nvl/data/List.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timer wheel holding values which become due after some number of ticks.
+ *
+ * Level L has kSlots slots which each span kSlots^L ticks. Values are placed in the lowest level whose range covers
+ * their delay, and are moved down a level each time the level below wraps around, so scheduling is O(1) and each
+ * value is moved at most kLevels times before it is due. Values further away than the top level can reach wait in an
+ * overflow list, which is redistributed each time the top level wraps around.
+ *
+ * Advancing only visits the slot of the current tick, so dormant values cost nothing until they are due.
+ *
+ * Each scheduled value is given a unique id, so that a wheel can be rewound (see drain) by rescheduling exactly the
+ * values which were pending or became due since, less those which were scheduled since.
+ *
+ * @tparam T Value type.
+ * @tparam kLevels Number of levels, which together cover delays of up to kSlots^kLevels ticks without overflowing.
+ */
+template <typename T, U64 kLevels = 4>
+class TimerWheel {
+public:
+    static constexpr U64 kBits = 6;
+    static constexpr U64 kSlots = 1 << kBits;
+    static constexpr U64 kMask = kSlots - 1;
+
+    struct Entry {
+        U64 due; // Tick at which the value is due
+        U64 id;  // Unique id assigned when the value was scheduled
+        T value;
+    };
+
+    /// Schedules `value` to become due `delay` ticks from now. Values with a delay of 0 are due on the next tick.
+    /// Returns the id of the scheduled value.
+    U64 schedule(const U64 delay, T value) {
+        const U64 id = next_id_++;
+        schedule(Entry{.due = now_ + std::max<U64>(delay, 1), .id = id, .value = std::move(value)});
+        return id;
+    }
+
+    /// Schedules an entry again with its original id, e.g. after rewinding. Entries which are already due are due on
+    /// the next tick.
+    void schedule(Entry entry) {
+        entry.due = std::max(entry.due, now_ + 1);
+        place(std::move(entry));
+        size_ += 1;
+    }
+
+    /// Advances by one tick, returning all values which are now due in the order they were scheduled.
+    List<T> advance() {
+        List<T> due;
+        for (Entry &entry : expire()) {
+            due.push_back(std::move(entry.value));
+        }
+        return due;
+    }
+
+    /// Advances by one tick, returning the entries of all values which are now due in the order they were scheduled.
+    List<Entry> expire() {
+        now_ += 1;
+        // Cascade each level whose next slot was reached, starting from the top so values can fall several levels
+        U64 top = 0;
+        while (top + 1 < kLevels && slot(top, now_) == 0) {
+            top += 1;
+        }
+        if (top + 1 == kLevels && slot(top, now_) == 0) {
+            List<Entry> overflow = std::move(overflow_);
+            overflow_ = {};
+            for (Entry &entry : overflow) {
+                place(std::move(entry));
+            }
+        }
+        for (U64 level = top; level > 0; --level) {
+            List<Entry> entries = std::move(levels_[level][slot(level, now_)]);
+            levels_[level][slot(level, now_)] = {};
+            for (Entry &entry : entries) {
+                place(std::move(entry));
+            }
+        }
+
+        List<Entry> due = std::move(levels_[0][slot(0, now_)]);
+        levels_[0][slot(0, now_)] = {};
+        size_ -= due.size();
+        // Values cascaded from higher levels may follow values scheduled later directly into this slot
+        due.sort([](const Entry &a, const Entry &b) { return a.id < b.id; });
+        return due;
+    }
+
+    /// Removes and returns the entries of all values which are not yet due in the order they were scheduled, and
+    /// restarts the wheel at tick `now`.
+    /// Entries can then be scheduled again with schedule(Entry).
+    List<Entry> drain(const U64 now) {
+        List<Entry> entries = std::move(overflow_);
+        overflow_ = {};
+        for (auto &level : levels_) {
+            for (List<Entry> &list : level) {
+                for (Entry &entry : list) {
+                    entries.push_back(std::move(entry));
+                }
+                list.clear();
+            }
+        }
+        entries.sort([](const Entry &a, const Entry &b) { return a.id < b.id; });
+        now_ = now;
+        size_ = 0;
+        return entries;
+    }
+
+    /// Returns the number of ticks advanced so far.
+    pure U64 now() const { return now_; }
+
+    /// Returns the number of values which are not yet due.
+    pure U64 size() const { return size_; }
+    pure bool empty() const { return size_ == 0; }
+
+private:
+    pure static U64 slot(const U64 level, const U64 time) { return (time >> (level * kBits)) & kMask; }
+
+    void place(Entry entry) {
+        const U64 delay = entry.due - now_;
+        for (U64 level = 0; level < kLevels; ++level) {
+            if (delay < (U64(1) << ((level + 1) * kBits))) {
+                levels_[level][slot(level, entry.due)].push_back(std::move(entry));
+                return;
+            }
+        }
+        overflow_.push_back(std::move(entry));
+    }
+
+    std::array<std::array<List<Entry>, kSlots>, kLevels> levels_;
+    List<Entry> overflow_;
+    U64 now_ = 0;
+    U64 size_ = 0;
+    U64 next_id_ = 0;
+};
+
+} // namespace nvl
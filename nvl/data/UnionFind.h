@@ -51,7 +51,7 @@ public:
         return *this;
     }
 
-    pure bool has(const Item &item) const { return ids_.contains(item); }
+    pure bool has(const Item &item) const { return ids_.has(item); }
 
     pure Range<Group> sets() const { return groups_.values(); }
 
@@ -59,8 +59,11 @@ private:
     void move_to_current_group(U64 dst, U64 &src, Group &group, const Item &item) {
         if (src != dst) {
             if (auto iter = groups_.find(src); iter != groups_.end()) {
-                const auto &set = iter->second;
-                group.insert(set.values());
+                // Every member of the merged set now belongs to the current group, not just `item`
+                for (const Item &member : iter->second) {
+                    ids_[member] = dst;
+                }
+                group.insert(iter->second.values());
                 groups_.erase(iter);
             } else {
                 group.insert(item);
@@ -14,25 +14,28 @@ class Block : public Entity<N> {
 public:
     class_tag(Block<N>, Entity<N>);
 
-    explicit Block(Pos<2> loc, const Box<N> &box, Material material) : Entity<N>(loc), material_(std::move(material)) {
+    explicit Block(Pos<N> loc, const Box<N> &box, const Material material) : Entity<N>(loc), material_(material) {
         this->parts_.emplace(box, material_);
     }
 
-    explicit Block(Pos<2> loc, Range<Ref<Part<N>>> parts) : Entity<N>(loc, parts) {
+    explicit Block(Pos<N> loc, Range<Ref<Part<N>>> parts) : Entity<N>(loc, parts) {
         if (!this->relative.parts().empty()) {
             material_ = this->relative.parts().begin()->raw().material;
         }
     }
 
     void draw(Window *window, const Color::Options &options) const override {
-        const auto color = material_->color.highlight(options);
-        for (const At<N, Part<N>> &part : this->parts()) {
-            window->fill_rectangle(color, part.bbox());
-        }
-        if (material_->outline) {
-            const auto edge_color = color.highlight({.scale = Color::kDarker});
-            for (const At<N, Edge<N>> &edge : this->edges()) {
-                window->line_rectangle(edge_color, edge.bbox());
+        // Only 2D blocks can currently be drawn
+        if constexpr (N == 2) {
+            const auto color = material_->color.highlight(options);
+            for (const At<N, Part<N>> &part : this->parts()) {
+                window->fill_rectangle(color, part.bbox());
+            }
+            if (material_->outline) {
+                const auto edge_color = color.highlight({.scale = Color::kDarker});
+                for (const At<N, Edge<N>> &edge : this->edges()) {
+                    window->line_rectangle(edge_color, edge.bbox());
+                }
             }
         }
     }
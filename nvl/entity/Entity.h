@@ -11,6 +11,8 @@
 #include "nvl/message/Hit.h"
 #include "nvl/message/Message.h"
 #include "nvl/message/Notify.h"
+#include "nvl/time/Profiler.h"
+#include "nvl/world/ContactGraph.h"
 #include "nvl/world/World.h"
 
 namespace nvl {
@@ -24,7 +26,7 @@ public:
     static constexpr U64 kGridExpMax = 10;
     using Tree = BRTree<N, Part<N>, Ref<Part<N>>, kMaxEntries, kGridExpMin, kGridExpMax>;
 
-    explicit Entity(Pos<2> loc, Range<Ref<Part<N>>> parts = {}) : parts_(loc, parts) {}
+    explicit Entity(Pos<N> loc, Range<Ref<Part<N>>> parts = {}) : parts_(loc, parts) {}
 
     pure Pos<N> loc() const { return parts_.loc; }
     pure Box<N> bbox() const { return parts_.bbox(); }
@@ -32,6 +34,21 @@ public:
     pure const Pos<N> &velocity() const { return velocity_; }
     pure const Pos<N> &accel() const { return accel_; }
 
+    void set_loc(const Pos<N> &loc) { parts_.loc = loc; }
+    void set_velocity(const Pos<N> &velocity) { velocity_ = velocity; }
+    void set_accel(const Pos<N> &accel) { accel_ = accel; }
+
+    /// Replaces all parts of this entity, e.g. when restoring a previous state.
+    void set_parts(const List<Part<N>> &parts) {
+        const List<Ref<Part<N>>> prev(relative.parts());
+        for (const Ref<Part<N>> &part : prev) {
+            parts_.remove(part);
+        }
+        for (const Part<N> &part : parts) {
+            parts_.insert(part);
+        }
+    }
+
     pure Range<At<N, Edge<N>>> edges() const { return parts_.edges(); }
     pure Range<At<N, Part<N>>> parts() const { return parts_.items(); }
     pure Range<At<N, Part<N>>> parts(const Box<N> &box) const { return parts_[box]; }
@@ -50,19 +67,45 @@ public:
         return relative.parts().all([](const Ref<Part<N>> part) { return part->material->falls; });
     }
 
+    /// Returns true if ticking this entity without any messages only moves it under gravity, as Entity::tick does, so
+    /// that the world may integrate it in a batch with other free-falling entities instead of ticking it.
+    /// Subclasses which override tick should return false.
+    pure virtual bool is_ballistic() const { return falls(); }
+
     Status tick(const List<Message> &messages) override;
 
     void bind(World<N> *world) { world_ = world; }
 
+    /// Returns the set of entities directly above this entity.
+    pure Set<Actor> above() const { return neighbors(world_->contacts().above(self())); }
+
+    /// Returns the set of entities directly below (supporting) this entity.
+    pure Set<Actor> below() const { return neighbors(world_->contacts().below(self())); }
+
+    /// Returns true if there is at least one entity directly below this entity.
+    pure bool has_below() const { return world_->contacts().has_below(self()); }
+
+    /// Finds the entities touching this entity's edges in the vertical dimension in direction `dir`, along with the
+    /// touching segments. Segments are always the bottom cells of the upper entity, so that both sides of a contact
+    /// agree. This queries the world directly; above() and below() use the world's cached contact graph.
+    pure typename ContactGraph<N>::Contacts find_contacts(Dir dir) const;
+
+    /// Finds the contacts above and below this entity, as with find_contacts(Dir), with a single query of the world.
+    pure std::pair<typename ContactGraph<N>::Contacts, typename ContactGraph<N>::Contacts> find_contacts() const;
+
 protected:
     friend struct Relative;
 
     using Component = typename Tree::ItemTree::Component;
     virtual Status broken(const List<Component> &components) = 0;
 
-    pure Set<Actor> above() const;
-
-    pure bool has_below() const;
+    pure static Set<Actor> neighbors(const typename ContactGraph<N>::Contacts &contacts) {
+        Set<Actor> neighbors;
+        for (const auto &[actor, _] : contacts) {
+            neighbors.insert(actor);
+        }
+        return neighbors;
+    }
 
     pure Pos<N> next_velocity() const;
 
@@ -81,6 +124,12 @@ protected:
         world_->template send<Msg>(self(), dst, std::forward<Args>(args)...);
     }
 
+    /// Sends a message of type `Msg` to this entity `ticks` ticks from now (see World::schedule).
+    template <typename Msg, typename... Args>
+    void schedule(const U64 ticks, Args &&...args) {
+        world_->schedule(self(), ticks, Message::get<Msg>(self(), std::forward<Args>(args)...));
+    }
+
     template <typename Type, typename... Args>
     void spawn(Args &&...args) {
         world_->template spawn_by<Type>(self(), std::forward<Args>(args)...);
@@ -96,36 +145,34 @@ protected:
 };
 
 template <U64 N>
-Set<Actor> Entity<N>::above() const {
-    Set<Actor> above;
-    for (const At<N, Edge<N>> &edge : parts_.edges()) {
-        if (World<N>::is_up(edge->dim, edge->dir)) {
-            const Box<N> box = edge.bbox();
-            for (const Actor &actor : world_->entities(box)) {
-                if (auto *entity = actor.dyn_cast<Entity<N>>(); entity && entity != this) {
-                    auto overlapping = entity->parts(box);
-                    if (!overlapping.empty()) {
-                        above.insert(actor);
-                    }
-                }
-            }
-        }
-    }
-    return above;
+typename ContactGraph<N>::Contacts Entity<N>::find_contacts(const Dir dir) const {
+    auto [above, below] = find_contacts();
+    return dir == Dir::Neg ? std::move(above) : std::move(below);
 }
 
 template <U64 N>
-bool Entity<N>::has_below() const {
+std::pair<typename ContactGraph<N>::Contacts, typename ContactGraph<N>::Contacts> Entity<N>::find_contacts() const {
+    std::pair<typename ContactGraph<N>::Contacts, typename ContactGraph<N>::Contacts> contacts;
+    List<Box<N>> boxes;
+    List<Dir> dirs;
     for (const At<N, Edge<N>> &edge : parts_.edges()) {
-        if (World<N>::is_down(edge->dim, edge->dir)) {
-            const Box<N> box = edge.bbox();
-            for (const Actor &actor : world_->entities(box)) {
-                const Entity<N> &entity = *actor.dyn_cast<Entity<N>>();
-                return_if(entity.parts(box).empty(), true);
-            }
+        if (edge->dim == World<N>::kVerticalDim) {
+            boxes.push_back(edge.bbox());
+            dirs.push_back(edge->dir);
         }
     }
-    return false;
+    world_->query_many(boxes.range(), [&](const U64 i, const Actor &actor) {
+        if (const auto *entity = actor.dyn_cast<Entity<N>>(); entity && entity != this) {
+            // Edges below this entity are outside of it, so shift those segments back up into this entity
+            const bool is_below = dirs[i] == Dir::Pos;
+            const Pos<N> offset = is_below ? Pos<N>::unit(World<N>::kVerticalDim, 1) : Pos<N>::zero;
+            auto &side = is_below ? contacts.second : contacts.first;
+            for (const At<N, Part<N>> &part : entity->parts(boxes[i])) {
+                side[actor].push_back(part.bbox().intersect(boxes[i]).value() - offset);
+            }
+        }
+    });
+    return contacts;
 }
 
 template <U64 N>
@@ -136,19 +183,25 @@ Pos<N> Entity<N>::next_velocity() const {
         const I64 a = accel_[i];
         I64 v_next = std::clamp(v + a, -world_->kMaxVelocity, world_->kMaxVelocity);
         if (v != 0 || a != 0) {
+            // Sweep all parts at once. Obstacles beyond the closest one cannot lower the velocity further, so sweeping
+            // every part over the full velocity finds the same bound as sweeping each only as far as is still possible.
+            List<I64> starts;
+            List<Box<N>> trajectories;
             for (const auto &part : parts()) {
                 const Box<N> box = part.bbox();
                 const I64 x = (v >= 0) ? box.max[i] : box.min[i];
-                const Box<N> trj = box.with(i, x, x + v_next);
-                for (Actor actor : world_->entities(trj)) {
-                    if (auto *entity = actor.dyn_cast<Entity<N>>(); entity && entity != this) {
-                        for (const auto &other : entity->parts(trj)) {
-                            const I64 bound = (v >= 0) ? other.bbox().min[i] - 1 : other.bbox().max[i] + 1;
-                            v_next = (v >= 0) ? std::min(v_next, bound - x) : std::max(v_next, bound - x);
-                        }
+                starts.push_back(x);
+                trajectories.push_back(box.with(i, x, x + v_next));
+            }
+            world_->query_many(trajectories.range(), [&](const U64 k, const Actor &actor) {
+                if (const auto *entity = actor.dyn_cast<Entity<N>>(); entity && entity != this) {
+                    const I64 x = starts[k];
+                    for (const auto &other : entity->parts(trajectories[k])) {
+                        const I64 bound = (v >= 0) ? other.bbox().min[i] - 1 : other.bbox().max[i] + 1;
+                        v_next = (v >= 0) ? std::min(v_next, bound - x) : std::max(v_next, bound - x);
                     }
                 }
-            }
+            });
         }
         velocity[i] = v_next;
     }
@@ -178,14 +231,18 @@ Status Entity<N>::receive(const List<Message> &messages) {
 
 template <U64 N>
 Status Entity<N>::hit(const Hit<N> &hit) {
+    profile_scope("entity.hit");
     const Box<N> local_box = hit.box - parts_.loc;
     const List<Ref<Part<N>>> hit_parts(relative.parts(local_box));
     return_if(hit_parts.empty(), Status::kNone);
 
+    List<Box<N>> areas;
+    for (const Ref<Part<N>> &part : hit_parts) {
+        areas.push_back(part->bbox().widened(1));
+    }
     Set<Actor> neighbors;
+    world_->query_many(areas.range(), [&](const U64, const Actor &actor) { neighbors.insert(actor); });
     for (const Ref<Part<N>> &part : hit_parts) {
-        const Box<N> area = part->bbox().widened(1);
-        neighbors.insert(world_->entities(area));
         if (part->health > hit.strength) {
             parts_.emplace(part->bbox().intersect(local_box).value(), part->material, part->health - hit.strength);
         }
@@ -195,6 +252,8 @@ Status Entity<N>::hit(const Hit<N> &hit) {
         parts_.remove(part);
     }
 
+    neighbors.remove(self());
+
     const List<Component> components = parts_.relative.components();
     const bool was_broken = components.size() != 1;
     const auto cause = was_broken ? Notify::kBroken : Notify::kChanged;
@@ -207,19 +266,32 @@ Status Entity<N>::tick(const List<Message> &messages) {
     // Early exit if we aren't attached to a world
     return_if(world_ == nullptr, Status::kNone);
 
-    Status status = receive(messages);
+    profile_scope("entity.tick");
+    Status status = Status::kNone;
+    {
+        profile_scope("entity.receive");
+        status = receive(messages);
+    }
     return_if(status == Status::kDied, status);
 
-    if (falls() && !has_below()) {
-        accel_ += world_->kGravity;
+    {
+        profile_scope("entity.gravity");
+        if (falls()) {
+            // Accelerate while unsupported, and stop accelerating once resting on something
+            accel_ = has_below() ? Pos<N>::zero : accel_ + world_->kGravity;
+        }
     }
 
     const Pos<N> init_velocity = velocity_;
-    velocity_ = next_velocity();
+    {
+        profile_scope("entity.velocity");
+        velocity_ = next_velocity();
+    }
 
     if (velocity_ != Pos<N>::zero) {
-        if (init_velocity != Pos<N>::zero) {
+        if (init_velocity == Pos<N>::zero) {
             // When starting to move, notify anything above
+            profile_scope("entity.notify");
             const Set<Actor> neighbors = above();
             send<Notify>(neighbors.values(), Notify::kMoved);
         }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "nvl/data/Iterator.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
 #include "nvl/geo/At.h"
 #include "nvl/geo/Box.h"
+#include "nvl/geo/BoxArray.h"
 #include "nvl/geo/HasBBox.h"
 #include "nvl/geo/RTree.h"
 #include "nvl/macros/Aliases.h"
@@ -33,12 +36,21 @@ protected:
             changed_ = false;
             edges_.clear();
 
+            // Find the neighbors of all values at once, since only neighbors can cover the edges of a value
+            // The neighbors are tested against every edge of the value, so their boxes are gathered into a BoxArray
+            Map<ItemRef, BoxArray<N>, typename ItemTree::ItemRefHash> neighbors;
+            items_.pairs_within(1, [&](const ItemRef &a, const ItemRef &b) {
+                neighbors[a].push_back(bbox(b));
+                neighbors[b].push_back(bbox(a));
+            });
+
             // Recompute edges across all values
             for (const ItemRef &item : items_) {
+                const BoxArray<N> *boxes = neighbors.get(item);
                 for (const Edge<N> &edge : bbox(item).edges()) {
                     List<Box<N>> overlap;
-                    for (const ItemRef &b : items_[edge.bbox()]) {
-                        overlap.push_back(bbox(b));
+                    if (boxes != nullptr) {
+                        boxes->overlapping(edge.bbox(), [&](const U64 i) { overlap.push_back((*boxes)[i]); });
                     }
                     Range<Box<N>> overlap_range = overlap.range();
                     for (const Edge<N> &remain : edge.diff(overlap_range)) {
@@ -123,10 +135,10 @@ public:
     explicit BRTree(Range<Item> items) : Parent(items) {}
     explicit BRTree(Range<ItemRef> items) : Parent(items) {}
 
-    BRTree(Pos<2> loc, std::initializer_list<Item> items) : Parent(items), loc(loc) {}
-    BRTree(Pos<2> loc, std::initializer_list<ItemRef> items) : Parent(items), loc(loc) {}
-    explicit BRTree(Pos<2> loc, Range<Item> items) : Parent(items), loc(loc) {}
-    explicit BRTree(Pos<2> loc, Range<ItemRef> items) : Parent(items), loc(loc) {}
+    BRTree(Pos<N> loc, std::initializer_list<Item> items) : Parent(items), loc(loc) {}
+    BRTree(Pos<N> loc, std::initializer_list<ItemRef> items) : Parent(items), loc(loc) {}
+    explicit BRTree(Pos<N> loc, Range<Item> items) : Parent(items), loc(loc) {}
+    explicit BRTree(Pos<N> loc, Range<ItemRef> items) : Parent(items), loc(loc) {}
 
     BRTree &insert(const Item &item) {
         this->items_.insert(item);
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <concepts>
+#include <type_traits>
+
 #include "nvl/data/Iterator.h"
 #include "nvl/data/List.h"
 #include "nvl/data/Maybe.h"
 #include "nvl/data/Range.h"
+#include "nvl/data/StaticList.h"
 #include "nvl/geo/Dir.h"
 #include "nvl/geo/HasBBox.h"
 #include "nvl/geo/Pos.h"
@@ -12,10 +17,10 @@
 
 namespace nvl {
 
-template <U64 N>
+template <U64 N, typename T = I64>
 struct Edge;
 
-template <U64 N>
+template <U64 N, typename T = I64>
 class Box {
 public:
     static const Box kUnitBox;
@@ -23,7 +28,7 @@ public:
     /// Returns a Box with `min` and `max` if min is strictly less than or equal to max.
     /// Returns None otherwise.
     /// Used to detect cases e.g. where intersection results in an empty Box.
-    static Maybe<Box> get(const Pos<N> &min, const Pos<N> &max) {
+    static constexpr Maybe<Box> get(const Pos<N, T> &min, const Pos<N, T> &max) {
         if (min.all_lte(max)) {
             return Box(min, max);
         }
@@ -31,24 +36,24 @@ public:
     }
 
     /// Returns a Box with only one point.
-    static Box unit(const Pos<N> &pt) { return Box(pt, pt); }
+    static Box unit(const Pos<N, T> &pt) { return Box(pt, pt); }
 
-    struct pos_iterator final : AbstractIteratorCRTP<pos_iterator, Pos<N>> {
-        class_tag(Box<N>::pos_iterator, AbstractIterator<Pos<N>>);
+    struct pos_iterator final : AbstractIteratorCRTP<pos_iterator, Pos<N, T>> {
+        class_tag(Box::pos_iterator, AbstractIterator<Pos<N, T>>);
 
         template <View Type = View::kImmutable>
             requires(Type == View::kImmutable)
-        static Iterator<Pos<N>, Type> begin(const Box &box, const Pos<N> &step) {
+        static Iterator<Pos<N, T>, Type> begin(const Box &box, const Pos<N, T> &step) {
             return make_iterator<pos_iterator>(box, box.min, step);
         }
         template <View Type = View::kImmutable>
             requires(Type == View::kImmutable)
-        static Iterator<Pos<N>, Type> end(const Box &box, const Pos<N> &step) {
+        static Iterator<Pos<N, T>, Type> end(const Box &box, const Pos<N, T> &step) {
             return make_iterator<pos_iterator>(box, None, step);
         }
 
-        pos_iterator() : pos_iterator(kUnitBox, None, Pos<N>::fill(1)) {}
-        explicit pos_iterator(const Box &box, const Maybe<Pos<N>> &pos, const Pos<N> &step)
+        pos_iterator() : pos_iterator(kUnitBox, None, Pos<N, T>::fill(1)) {}
+        explicit pos_iterator(const Box &box, const Maybe<Pos<N, T>> &pos, const Pos<N, T> &step)
             : box_(box), pos_(pos), step_(step) {
             for (U64 i = 0; i < N; i++) {
                 ASSERT(step_[i] != 0, "Invalid iterator step size of 0");
@@ -56,7 +61,7 @@ public:
             }
         }
 
-        const Pos<N> *ptr() override { return &pos_.value(); }
+        const Pos<N, T> *ptr() override { return &pos_.value(); }
 
         pure bool operator==(const pos_iterator &rhs) const override {
             return pos_ == rhs.pos_ && box_ == rhs.box_ && step_ == rhs.step_;
@@ -80,27 +85,27 @@ public:
             }
         }
 
-        Box<N> box_;
-        Maybe<Pos<N>> pos_;
-        Pos<N> step_;
+        Box box_;
+        Maybe<Pos<N, T>> pos_;
+        Pos<N, T> step_;
     };
 
-    struct box_iterator final : AbstractIteratorCRTP<box_iterator, Box<N>> {
-        class_tag(Box<N>::box_iterator, AbstractIterator<Box<N>>);
+    struct box_iterator final : AbstractIteratorCRTP<box_iterator, Box> {
+        class_tag(Box::box_iterator, AbstractIterator<Box>);
 
         template <View Type = View::kImmutable>
             requires(Type == View::kImmutable)
-        static Iterator<Box<N>, Type> begin(const Box &box, const Pos<N> &shape = Pos<N>::fill(1)) {
+        static Iterator<Box, Type> begin(const Box &box, const Pos<N, T> &shape = Pos<N, T>::fill(1)) {
             return make_iterator<box_iterator, Type>(box, Box(box.min, box.min + shape - 1), shape);
         }
         template <View Type = View::kImmutable>
             requires(Type == View::kImmutable)
-        static Iterator<Box<N>, Type> end(const Box &box, const Pos<N> &shape = Pos<N>::fill(1)) {
+        static Iterator<Box, Type> end(const Box &box, const Pos<N, T> &shape = Pos<N, T>::fill(1)) {
             return make_iterator<box_iterator, Type>(box, None, shape);
         }
 
-        box_iterator() : box_iterator(kUnitBox, None, Pos<N>::fill(1)) {}
-        explicit box_iterator(const Box &box, const Maybe<Box> &cur, const Pos<N> &shape)
+        box_iterator() : box_iterator(kUnitBox, None, Pos<N, T>::fill(1)) {}
+        explicit box_iterator(const Box &box, const Maybe<Box> &cur, const Pos<N, T> &shape)
             : box_(box), current_(cur), shape_(shape) {
             for (U64 i = 0; i < N; i++) {
                 ASSERT(shape_[i] != 0, "Invalid iterator shape size of 0");
@@ -134,15 +139,21 @@ public:
             }
         }
 
-        Box<N> box_;
+        Box box_;
         Maybe<Box> current_;
-        Pos<N> shape_;
+        Pos<N, T> shape_;
     };
     explicit Box() = default;
 
+    /// Converts a Box with another coordinate type. Conversions which may overflow must be explicit, and are checked
+    /// in debug builds.
+    template <typename U>
+        requires(!std::same_as<T, U>)
+    explicit(!kLossless<U, T>) constexpr Box(const Box<N, U> &box) : min(box.min), max(box.max) {}
+
     /// Returns a Box from points `a` to `b` (inclusive).
     /// Registers `min` and `max` fields to be the min and max in each dimension, respectively.
-    constexpr Box(const Pos<N> &a, const Pos<N> &b) {
+    constexpr Box(const Pos<N, T> &a, const Pos<N, T> &b) {
         for (U64 i = 0; i < N; i++) {
             min[i] = std::min(a[i], b[i]);
             max[i] = std::max(a[i], b[i]);
@@ -152,9 +163,9 @@ public:
     /// Returns the number of dimensions in this box.
     pure constexpr I64 rank() const { return N; }
 
-    pure Pos<N> shape() const { return max - min + 1; }
+    pure Pos<N, T> shape() const { return max - min + 1; }
 
-    pure Box with(const U64 dim, const I64 lo, const I64 hi) const {
+    pure Box with(const U64 dim, const T lo, const T hi) const {
         return Box(this->min.with(dim, lo), this->max.with(dim, hi));
     }
 
@@ -162,42 +173,42 @@ public:
     pure Box operator-() const { return Box(-min, -max); }
 
     /// Returns a new Box scaled by the corresponding factors in `scale`.
-    pure Box operator*(const Pos<N> &scale) const { return Box(min * scale, max * scale); }
+    pure Box operator*(const Pos<N, T> &scale) const { return Box(min * scale, max * scale); }
 
     /// Returns a new Box scaled by the factor `scale` in every dimension.
-    pure Box operator*(const I64 scale) const { return Box(min * scale, max * scale); }
+    pure Box operator*(const T scale) const { return Box(min * scale, max * scale); }
 
     /// Returns a new Box shifted by `rhs`.
-    pure Box operator+(const Pos<N> &rhs) const { return Box(min + rhs, max + rhs); }
-    pure Box operator+(const I64 rhs) const { return Box(min + rhs, max + rhs); }
-    pure Box operator-(const Pos<N> &rhs) const { return Box(min - rhs, max - rhs); }
-    pure Box operator-(const I64 rhs) const { return Box(min - rhs, max - rhs); }
+    pure Box operator+(const Pos<N, T> &rhs) const { return Box(min + rhs, max + rhs); }
+    pure Box operator+(const T rhs) const { return Box(min + rhs, max + rhs); }
+    pure Box operator-(const Pos<N, T> &rhs) const { return Box(min - rhs, max - rhs); }
+    pure Box operator-(const T rhs) const { return Box(min - rhs, max - rhs); }
 
     /// Returns a new Box which is clamped to the given grid size.
-    pure Box clamp(const Pos<N> &grid) const { return Box(min.grid_min(grid), max.grid_max(grid)); }
-    pure Box clamp(const I64 grid) const { return Box(min.grid_min(grid), max.grid_max(grid)); }
+    pure Box clamp(const Pos<N, T> &grid) const { return Box(min.grid_min(grid), max.grid_max(grid)); }
+    pure Box clamp(const T grid) const { return Box(min.grid_min(grid), max.grid_max(grid)); }
 
     /// Returns an iterator over points in this box with the given `step` size in each dimension.
-    pure Range<Pos<N>> pos_iter(const I64 step = 1) const { return pos_iter(Pos<N>::fill(step)); }
+    pure Range<Pos<N, T>> pos_iter(const T step = 1) const { return pos_iter(Pos<N, T>::fill(step)); }
 
     /// Returns an iterator over points in this box with the given multidimensional `step` size.
-    pure Range<Pos<N>> pos_iter(const Pos<N> &step) const { return make_range<pos_iterator>(*this, step); }
+    pure Range<Pos<N, T>> pos_iter(const Pos<N, T> &step) const { return make_range<pos_iterator>(*this, step); }
 
     /// Returns an iterator over sub-boxes with the given `step` size in each dimension.
-    pure Range<Box<N>> box_iter(const I64 step) const { return make_range<box_iterator>(*this, Pos<N>::fill(step)); }
+    pure Range<Box> box_iter(const T step) const { return make_range<box_iterator>(*this, Pos<N, T>::fill(step)); }
 
     /// Returns an iterator over sub-boxes with the given multidimensional `step` size.
-    pure Range<Box<N>> box_iter(const Pos<N> &shape) const { return make_range<box_iterator>(*this, shape); }
+    pure Range<Box> box_iter(const Pos<N, T> &shape) const { return make_range<box_iterator>(*this, shape); }
 
     /// Provides iteration over all points in this box.
-    pure Iterator<Pos<N>> begin() const { return pos_iterator::template begin(*this, Pos<N>::ones); }
-    pure Iterator<Pos<N>> end() const { return pos_iterator::template end(*this, Pos<N>::ones); }
+    pure Iterator<Pos<N, T>> begin() const { return pos_iterator::template begin(*this, Pos<N, T>::ones); }
+    pure Iterator<Pos<N, T>> end() const { return pos_iterator::template end(*this, Pos<N, T>::ones); }
 
-    pure bool operator==(const Box &rhs) const { return min == rhs.min && max == rhs.max; }
-    pure bool operator!=(const Box &rhs) const { return !(*this == rhs); }
+    pure constexpr bool operator==(const Box &rhs) const { return min == rhs.min && max == rhs.max; }
+    pure constexpr bool operator!=(const Box &rhs) const { return !(*this == rhs); }
 
     /// Returns true if there is any overlap between this Box and `rhs`.
-    pure bool overlaps(const Box &rhs) const {
+    pure constexpr bool overlaps(const Box &rhs) const {
         for (U64 i = 0; i < N; ++i) {
             if (min[i] > rhs.max[i] || max[i] < rhs.min[i]) {
                 return false;
@@ -206,8 +217,17 @@ public:
         return true;
     }
 
+    /// Returns the Manhattan distance between the closest points of this Box and `rhs`, or 0 if they overlap.
+    pure I64 manhattan_dist(const Box &rhs) const {
+        I64 result = 0;
+        for (U64 i = 0; i < N; ++i) {
+            result += std::max<I64>({0, min[i] - rhs.max[i], rhs.min[i] - max[i]});
+        }
+        return result;
+    }
+
     /// Returns true if `pt` is somewhere within this box.
-    pure bool contains(const Pos<N> &pt) const {
+    pure bool contains(const Pos<N, T> &pt) const {
         for (U64 i = 0; i < N; ++i) {
             if (pt[i] < min[i] || pt[i] > max[i]) {
                 return false;
@@ -217,7 +237,7 @@ public:
     }
 
     /// Returns the Box where this and `rhs` overlap. Returns None if there is no overlap.
-    pure Maybe<Box> intersect(const Box &rhs) const {
+    pure constexpr Maybe<Box> intersect(const Box &rhs) const {
         if (overlaps(rhs)) {
             return Box(nvl::max(min, rhs.min), nvl::min(max, rhs.max));
         }
@@ -225,9 +245,10 @@ public:
     }
 
     /// Returns the result of removing all points in `rhs` from this Box.
-    /// This may result in anywhere between 1 and N*N - 1 boxes, depending on the nature of the intersection.
-    pure List<Box> diff(const Box &rhs) const {
-        List<Box> result;
+    /// This may result in anywhere between 0 and 2N boxes, depending on the nature of the intersection, so they are
+    /// returned in a StaticList without allocating.
+    pure constexpr StaticList<Box, 2 * N> diff(const Box &rhs) const {
+        StaticList<Box, 2 * N> result;
         push_diff(result, rhs);
         return result;
     }
@@ -252,17 +273,17 @@ public:
 
     /// Returns the sides with given `width`.
     /// Sides begin at the outermost "pixel" of the box and extend inwards.
-    pure List<Edge<N>> sides(I64 width = 1) const;
+    pure constexpr StaticList<Edge<N, T>, 2 * N> sides(T width = 1) const;
 
     /// Returns the edges with given width and distance from the outermost pixel.
     /// Edges begin at `dist` "pixels" away from the outermost 'pixel" of the box and extend outwards.
-    pure List<Edge<N>> edges(I64 width = 1, I64 dist = 1) const;
+    pure constexpr StaticList<Edge<N, T>, 2 * N> edges(T width = 1, T dist = 1) const;
 
     /// Returns the edge on the side of the box in dimension `dim` in direction `dir`.
-    pure Edge<N> edge(U64 dim, Dir dir, I64 width = 1, I64 dist = 1) const;
+    pure constexpr Edge<N, T> edge(U64 dim, Dir dir, T width = 1, T dist = 1) const;
 
     /// Returns a new Box which is expanded by `size` in every direction/dimension.
-    pure Box widened(const U64 size) const { return Box(min - Pos<N>::fill(size), max + Pos<N>::fill(size)); }
+    pure Box widened(const U64 size) const { return Box(min - Pos<N, T>::fill(size), max + Pos<N, T>::fill(size)); }
 
     pure std::string to_string() const {
         std::stringstream ss;
@@ -272,20 +293,21 @@ public:
 
     const Box &bbox() const { return *this; }
 
-    Pos<N> min;
-    Pos<N> max;
+    Pos<N, T> min;
+    Pos<N, T> max;
 
 private:
     friend struct pos_iterator;
 
-    void push_diff(List<Box> &result, const Box &rhs) const {
+    template <typename Result>
+    constexpr void push_diff(Result &result, const Box &rhs) const {
         const Maybe<Box> intersect = this->intersect(rhs);
         if (intersect.has_value()) {
             const Box &both = *intersect;
             for (U64 i = 0; i < N; ++i) {
                 for (const Dir dir : Dir::list) {
-                    Pos<N> result_min;
-                    Pos<N> result_max;
+                    Pos<N, T> result_min;
+                    Pos<N, T> result_max;
                     for (U64 d = 0; d < N; ++d) {
                         if (i == d) {
                             result_min[d] = (dir == Dir::Neg) ? min[d] : both.max[d] + 1;
@@ -310,14 +332,14 @@ private:
     }
 };
 
-template <U64 N>
+template <U64 N, typename T>
 struct Edge {
     Edge() = default;
-    explicit Edge(const U64 dim, const Dir dir, const Box<N> &box) : dim(dim), dir(dir), box(box) {}
+    explicit constexpr Edge(const U64 dim, const Dir dir, const Box<N, T> &box) : dim(dim), dir(dir), box(box) {}
 
-    pure List<Edge> diff(const Box<N> &rhs) const {
-        List<Edge> result;
-        for (const Box<N> &b : box.diff(rhs)) {
+    pure constexpr StaticList<Edge, 2 * N> diff(const Box<N, T> &rhs) const {
+        StaticList<Edge, 2 * N> result;
+        for (const Box<N, T> &b : box.diff(rhs)) {
             result.emplace_back(dim, dir, b);
         }
         return result;
@@ -327,34 +349,38 @@ struct Edge {
         requires trait::HasBBox<Value>
     pure List<Edge> diff(Range<Value> range) const {
         List<Edge> result;
-        for (const Box<N> &b : box.diff(range)) {
+        for (const Box<N, T> &b : box.diff(range)) {
             result.emplace_back(dim, dir, b);
         }
         return result;
     }
 
-    pure bool operator==(const Edge &rhs) const { return dim == rhs.dim && dir == rhs.dir && box == rhs.box; }
-    pure bool operator!=(const Edge &rhs) const { return !(*this == rhs); }
+    pure constexpr bool operator==(const Edge &rhs) const { return dim == rhs.dim && dir == rhs.dir && box == rhs.box; }
+    pure constexpr bool operator!=(const Edge &rhs) const { return !(*this == rhs); }
 
     pure U64 thickness() const { return box.shape(dim); }
-    pure Box<N> bbox() const { return box; }
+    pure Box<N, T> bbox() const { return box; }
 
     U64 dim = 0;
     Dir dir;
-    Box<N> box;
+    Box<N, T> box;
 };
 
-template <U64 N>
-constexpr Box<N> Box<N>::kUnitBox = Box(Pos<N>::fill(-1), Pos<N>::fill(1));
+template <U64 N, typename T>
+constexpr Box<N, T> Box<N, T>::kUnitBox = Box(Pos<N, T>::fill(-1), Pos<N, T>::fill(1));
 
+/// A Box with compact 32-bit coordinates (see Pos32).
 template <U64 N>
-List<Edge<N>> Box<N>::sides(const I64 width) const {
+using Box32 = Box<N, I32>;
+
+template <U64 N, typename T>
+constexpr StaticList<Edge<N, T>, 2 * N> Box<N, T>::sides(const T width) const {
     return edges(-width, 0);
 }
 
-template <U64 N>
-List<Edge<N>> Box<N>::edges(const I64 width, const I64 dist) const {
-    List<Edge<N>> result;
+template <U64 N, typename T>
+constexpr StaticList<Edge<N, T>, 2 * N> Box<N, T>::edges(const T width, const T dist) const {
+    StaticList<Edge<N, T>, 2 * N> result;
     for (U64 i = 0; i < N; ++i) {
         for (const auto &dir : Dir::list) {
             result.push_back(edge(i, dir, width, dist));
@@ -363,54 +389,54 @@ List<Edge<N>> Box<N>::edges(const I64 width, const I64 dist) const {
     return result;
 }
 
-template <U64 N>
-Edge<N> Box<N>::edge(const U64 dim, const Dir dir, const I64 width, const I64 dist) const {
-    auto unit = Pos<N>::unit(dim);
+template <U64 N, typename T>
+constexpr Edge<N, T> Box<N, T>::edge(const U64 dim, const Dir dir, const T width, const T dist) const {
+    auto unit = Pos<N, T>::unit(dim);
     auto inner = unit * dist;
     auto outer = unit * (width - 1);
     auto edge_min = (dir == Dir::Neg) ? min - outer - inner : min.with(dim, max[dim]) + inner;
     auto edge_max = (dir == Dir::Neg) ? max.with(dim, min[dim]) - inner : max + outer + inner;
-    return Edge<N>(dim, dir, Box(edge_min, edge_max));
+    return Edge<N, T>(dim, dir, Box(edge_min, edge_max));
 }
 
-template <U64 N>
-Box<N> operator*(I64 a, const Box<N> &b) {
+template <U64 N, typename T>
+Box<N, T> operator*(std::type_identity_t<T> a, const Box<N, T> &b) {
     return b * a;
 }
-template <U64 N>
-Box<N> operator+(I64 a, const Box<N> &b) {
+template <U64 N, typename T>
+Box<N, T> operator+(std::type_identity_t<T> a, const Box<N, T> &b) {
     return b + a;
 }
-template <U64 N>
-Box<N> operator-(I64 a, const Box<N> &b) {
+template <U64 N, typename T>
+Box<N, T> operator-(std::type_identity_t<T> a, const Box<N, T> &b) {
     return -b + a;
 }
 
-template <U64 N>
-std::ostream &operator<<(std::ostream &os, const Box<N> &box) {
+template <U64 N, typename T>
+std::ostream &operator<<(std::ostream &os, const Box<N, T> &box) {
     return os << box.min << "::" << box.max;
 }
 
-template <U64 N>
-std::ostream &operator<<(std::ostream &os, const Edge<N> &edge) {
+template <U64 N, typename T>
+std::ostream &operator<<(std::ostream &os, const Edge<N, T> &edge) {
     return os << "Edge(" << edge.dim << ", " << edge.dir << ", " << edge.box << ")";
 }
 
 /// Returns the minimal Box which includes all of both Box `a` and `b`.
 /// Note that the resulting area may be larger than the sum of the two areas.
-template <U64 N>
-pure Box<N> bounding_box(const Box<N> &a, const Box<N> &b) {
-    return Box<N>(min(a.min, b.min), max(a.max, b.max));
+template <U64 N, typename T>
+pure Box<N, T> bounding_box(const Box<N, T> &a, const Box<N, T> &b) {
+    return Box<N, T>(min(a.min, b.min), max(a.max, b.max));
 }
 
 } // namespace nvl
 
-template <U64 N>
-struct std::hash<nvl::Box<N>> {
-    pure U64 operator()(const nvl::Box<N> &a) const noexcept { return nvl::sip_hash(a); }
+template <U64 N, typename T>
+struct std::hash<nvl::Box<N, T>> {
+    pure U64 operator()(const nvl::Box<N, T> &a) const noexcept { return nvl::sip_hash(a); }
 };
 
-template <U64 N>
-struct std::hash<nvl::Edge<N>> {
-    pure U64 operator()(const nvl::Edge<N> &a) const noexcept { return nvl::sip_hash(a); }
+template <U64 N, typename T>
+struct std::hash<nvl::Edge<N, T>> {
+    pure U64 operator()(const nvl::Edge<N, T> &a) const noexcept { return nvl::sip_hash(a); }
 };
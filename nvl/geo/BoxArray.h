@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "nvl/data/List.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Assert.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/// Returns a mask with bit `i` set if `boxes[i]` overlaps `query`, for the first `n` (at most 64) boxes.
+/// The comparisons are branch-free, so the loop can be vectorized by the compiler.
+template <U64 N>
+pure U64 overlap_mask(const Box<N> &query, const Box<N> *boxes, const U64 n) {
+    ASSERT(n <= 64, "Cannot compute the overlap mask of " << n << " boxes");
+    U64 mask = 0;
+    for (U64 i = 0; i < n; ++i) {
+        bool inside = true;
+        for (U64 d = 0; d < N; ++d) {
+            inside &= (boxes[i].min[d] <= query.max[d]) & (boxes[i].max[d] >= query.min[d]);
+        }
+        mask |= U64(inside) << i;
+    }
+    return mask;
+}
+
+/**
+ * @class BoxArray
+ * @brief Array of boxes stored as structure-of-arrays, for testing many boxes against a query box at once.
+ *
+ * The minimum and maximum coordinates of each dimension are kept in separate arrays, so four boxes are compared in
+ * each AVX2 instruction when compiled with AVX2 support, and the scalar fallback is easily vectorized otherwise.
+ * This pays off when the same boxes are tested against several queries, e.g. the items of an RTree cell against a
+ * batch of queries, since gathering the boxes costs about as much as one scalar scan.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ */
+template <U64 N>
+class BoxArray {
+public:
+    BoxArray() = default;
+
+    void push_back(const Box<N> &box) {
+        for (U64 d = 0; d < N; ++d) {
+            min_[d].push_back(box.min[d]);
+            max_[d].push_back(box.max[d]);
+        }
+    }
+
+    void clear() {
+        for (U64 d = 0; d < N; ++d) {
+            min_[d].clear();
+            max_[d].clear();
+        }
+    }
+
+    pure U64 size() const { return min_[0].size(); }
+    pure bool empty() const { return min_[0].empty(); }
+
+    /// Returns the box at index `i`.
+    pure Box<N> operator[](const U64 i) const {
+        Box<N> box;
+        for (U64 d = 0; d < N; ++d) {
+            box.min[d] = min_[d][i];
+            box.max[d] = max_[d][i];
+        }
+        return box;
+    }
+
+    /// Returns a mask with bit `i` set if box `offset + i` overlaps `query`, for up to 64 boxes starting at `offset`.
+    pure U64 overlap_mask(const Box<N> &query, const U64 offset = 0) const {
+        const U64 end = std::min(offset + 64, size());
+        U64 mask = 0;
+        U64 i = offset;
+#ifdef __AVX2__
+        for (; i + 4 <= end; i += 4) {
+            __m256i outside = _mm256_setzero_si256();
+            for (U64 d = 0; d < N; ++d) {
+                const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&min_[d][i]));
+                const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&max_[d][i]));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(lo, _mm256_set1_epi64x(query.max[d])));
+                outside = _mm256_or_si256(outside, _mm256_cmpgt_epi64(_mm256_set1_epi64x(query.min[d]), hi));
+            }
+            const U64 inside = ~static_cast<U64>(_mm256_movemask_pd(_mm256_castsi256_pd(outside))) & 0xF;
+            mask |= inside << (i - offset);
+        }
+#endif
+        for (; i < end; ++i) {
+            bool inside = true;
+            for (U64 d = 0; d < N; ++d) {
+                inside &= (min_[d][i] <= query.max[d]) & (max_[d][i] >= query.min[d]);
+            }
+            mask |= U64(inside) << (i - offset);
+        }
+        return mask;
+    }
+
+    /// Calls `f(i)` with the index of each box overlapping `query`, in increasing order.
+    template <typename F>
+    void overlapping(const Box<N> &query, F &&f) const {
+        for (U64 offset = 0; offset < size(); offset += 64) {
+            for (U64 mask = overlap_mask(query, offset); mask != 0; mask &= mask - 1) {
+                f(offset + std::countr_zero(mask));
+            }
+        }
+    }
+
+    /// Returns the intersections of `query` with each box overlapping it, in the order of the boxes.
+    pure List<Box<N>> intersect_all(const Box<N> &query) const {
+        List<Box<N>> result;
+        overlapping(query, [&](const U64 i) {
+            Box<N> both;
+            for (U64 d = 0; d < N; ++d) {
+                both.min[d] = std::max(min_[d][i], query.min[d]);
+                both.max[d] = std::min(max_[d][i], query.max[d]);
+            }
+            result.push_back(both);
+        });
+        return result;
+    }
+
+private:
+    List<I64> min_[N];
+    List<I64> max_[N];
+};
+
+} // namespace nvl
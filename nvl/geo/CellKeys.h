@@ -0,0 +1,47 @@
+#pragma once
+
+#include "nvl/data/Range.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/math/Morton.h"
+
+namespace nvl {
+
+/**
+ * @struct PosKeys
+ * @brief Policy for keying the cells of RTree nodes by the position of their minimum corner.
+ *
+ * A key policy maps cells of a node with a given (power of two) grid size to and from keys:
+ *   using Key = ...;
+ *   static Key key(const Pos<N> &pos, I64 grid);                 // Key of the cell containing `pos`
+ *   static Pos<N> pos(const Key &key, I64 grid);                 // Minimum corner of the cell with `key`
+ *   static Range<Pos<N>> cells_in(const Box<N> &box, I64 grid);  // Minimum corners of all cells overlapping `box`
+ */
+template <U64 N>
+struct PosKeys {
+    using Key = Pos<N>;
+    pure static Key key(const Pos<N> &pos, const I64 grid) { return pos.grid_min(grid); }
+    pure static Pos<N> pos(const Key &key, const I64) { return key; }
+    pure static Range<Pos<N>> cells_in(const Box<N> &box, const I64 grid) {
+        return box.clamp(grid).pos_iter(Pos<N>::fill(grid));
+    }
+};
+
+/**
+ * @struct MortonKeys
+ * @brief Policy for keying the cells of RTree nodes by their Morton code (see Morton.h).
+ *
+ * Keys are a single integer computed with shifts, so they are smaller and cheaper to hash than positions, and cells
+ * overlapping a box are enumerated in Morton order, so nearby cells are visited together.
+ */
+template <U64 N>
+struct MortonKeys {
+    using Key = U64;
+    pure static Key key(const Pos<N> &pos, const I64 grid) { return Morton<N>::encode(pos, grid); }
+    pure static Pos<N> pos(const Key &key, const I64 grid) { return Morton<N>::decode(key) * grid; }
+    pure static Range<Pos<N>> cells_in(const Box<N> &box, const I64 grid) { return Morton<N>::cells_in(box, grid); }
+};
+
+} // namespace nvl
@@ -18,8 +18,8 @@ public:
     Dir() = default;
 
     pure constexpr Dir operator-() const { return Dir(-value); }
-    pure bool operator==(const Dir &rhs) const { return value == rhs.value; }
-    pure bool operator!=(const Dir &rhs) const { return value != rhs.value; }
+    pure constexpr bool operator==(const Dir &rhs) const { return value == rhs.value; }
+    pure constexpr bool operator!=(const Dir &rhs) const { return value != rhs.value; }
 
 private:
     explicit constexpr Dir(const I64 v) : value(v) {}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/data/PointerHash.h"
+#include "nvl/data/Range.h"
+#include "nvl/data/Ref.h"
+#include "nvl/data/Shared.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/HasBBox.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+/**
+ * @class HashGrid
+ * @brief Spatial index which lists items in every cell of a single, uniform grid which they overlap.
+ *
+ * Cells are kept in a hash map, so only cells with items take up space. Lookups and updates are a few hash probes for
+ * items and queries which span few cells, which suits many small items of a similar size, such as rubble. Items much
+ * larger than a cell are listed in many cells, so worlds with large or sparse items are better served by an RTree.
+ *
+ * Queries do not need to track visited items: an item is only reported from the cell containing the minimum corner
+ * of its intersection with the query volume.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ * @tparam Item Value type being stored.
+ * @tparam kCellExp Size of each cell (2 ^ kCellExp). Defaults to 5.
+ */
+template <U64 N, typename Item, typename ItemRef = Ref<Item>, U64 kCellExp = 5>
+    requires trait::HasBBox<Item>
+class HashGrid {
+public:
+    using ItemRefHash = PointerHash<ItemRef>; // Hashing is done based on pointer, not value
+
+    static constexpr I64 kCellSize = I64(1) << kCellExp;
+
+    HashGrid() = default;
+
+    /// Inserts a copy of the item into the grid.
+    /// Returns a reference to the copy held by the grid.
+    ItemRef insert(const Item &item) { return take(std::make_unique<Item>(item)); }
+
+    /// Adds the item to the grid, taking ownership of it.
+    ItemRef take(std::unique_ptr<Item> item) {
+        const ItemRef ref(item.get());
+        list_over(ref, cells(item->bbox()));
+        items_[ref] = std::move(item);
+        return ref;
+    }
+
+    /// Adds all of the given items to the grid at once, taking ownership of them.
+    /// Returns references to the items held by the grid, in the same order. Cells have no structure to build, so
+    /// each item is simply listed in its cells.
+    List<ItemRef> take(std::vector<std::unique_ptr<Item>> items) {
+        List<ItemRef> refs;
+        for (std::unique_ptr<Item> &item : items) {
+            refs.push_back(take(std::move(item)));
+        }
+        return refs;
+    }
+
+    /// Constructs a new item and adds it to this grid.
+    /// Returns a reference to the new item held by the grid.
+    template <typename T = Item, typename... Args>
+    ItemRef emplace(Args &&...args) {
+        return take(std::make_unique<T>(std::forward<Args>(args)...));
+    }
+
+    /// Removes the matching item from the grid, if it exists.
+    HashGrid &remove(const ItemRef &item) {
+        release(item);
+        return *this;
+    }
+
+    /// Removes the matching item from the grid and returns ownership of it, or nullptr if it does not exist.
+    std::unique_ptr<Item> release(const ItemRef &item) {
+        std::unique_ptr<Item> *owned = items_.get(item);
+        return_if(owned == nullptr, nullptr);
+        std::unique_ptr<Item> result = std::move(*owned);
+        items_.remove(item);
+        unlist_over(item, cells(result->bbox()));
+        return result;
+    }
+
+    /// Registers the matching item as having moved from the previous volume `prev` to its current volume.
+    /// Does nothing if no matching item exists in the grid.
+    HashGrid &move(const ItemRef &item, const Box<N> &prev) {
+        return_if(!has(item), *this);
+        const Box<N> prev_cells = cells(prev);
+        const Box<N> new_cells = cells(bbox(item));
+        return_if(prev_cells == new_cells, *this); // Most moves stay within the same cells
+        for (const Box<N> &removed : prev_cells.diff(new_cells)) {
+            unlist_over(item, removed);
+        }
+        for (const Box<N> &added : new_cells.diff(prev_cells)) {
+            list_over(item, added);
+        }
+        return *this;
+    }
+
+    /// Returns an iterable range over all unique stored items in the given volume.
+    pure MRange<ItemRef> operator[](const Pos<N> &pos) { return operator[](Box<N>::unit(pos)); }
+    pure MRange<ItemRef> operator[](const Box<N> &box) { return shared<ItemRef, View::kMutable>(items_in(box)); }
+
+    pure Range<ItemRef> operator[](const Pos<N> &pos) const { return operator[](Box<N>::unit(pos)); }
+    pure Range<ItemRef> operator[](const Box<N> &box) const { return shared(items_in(box)); }
+
+    /// Calls `f(i, item)` once for each item overlapping the i-th of the given volumes (see RTree::query_many).
+    template <typename F>
+    void query_many(const Range<Box<N>> &boxes, F &&f) const {
+        U64 i = 0;
+        for (const Box<N> &box : boxes) {
+            visit(box, [&](const ItemRef &item) { f(i, item); });
+            i += 1;
+        }
+    }
+
+    /// Returns a Range for unordered iteration over all items in this grid.
+    pure Range<ItemRef> items() const { return items_.keys(); }
+
+    /// Returns true if this item is contained within the grid.
+    pure bool has(const ItemRef &item) const { return items_.has(item); }
+
+    /// Returns the total number of distinct items stored in this grid.
+    pure U64 size() const { return items_.size(); }
+
+    /// Returns true if this grid is empty.
+    pure bool empty() const { return items_.empty(); }
+
+    /// Returns the number of non-empty cells.
+    pure U64 num_cells() const { return cells_.size(); }
+
+    /// Re-lists all items from their current volumes, e.g. after items were modified without calling move.
+    void rebuild() {
+        cells_.clear();
+        for (const ItemRef &item : items()) {
+            list_over(item, cells(bbox(item)));
+        }
+    }
+
+    void clear() {
+        cells_.clear();
+        items_.clear();
+    }
+
+private:
+    static Box<N> bbox(const ItemRef &item) { return static_cast<const Item *>(item.ptr())->bbox(); }
+
+    /// Returns the index of the cell containing `pos`.
+    pure static Pos<N> cell(const Pos<N> &pos) {
+        Pos<N> result;
+        for (U64 d = 0; d < N; ++d) {
+            result[d] = pos[d] >> kCellExp; // Arithmetic shift, so negative positions round down
+        }
+        return result;
+    }
+
+    /// Returns the indices of the cells overlapping `box`.
+    pure static Box<N> cells(const Box<N> &box) { return Box<N>(cell(box.min), cell(box.max)); }
+
+    void list_over(const ItemRef &item, const Box<N> &range) {
+        for (const Pos<N> &pos : range) {
+            cells_[pos].push_back(item);
+        }
+    }
+
+    void unlist_over(const ItemRef &item, const Box<N> &range) {
+        for (const Pos<N> &pos : range) {
+            if (List<ItemRef> *list = cells_.get(pos)) {
+                list->remove(item);
+                if (list->empty()) {
+                    cells_.remove(pos);
+                }
+            }
+        }
+    }
+
+    /// Calls `f(item)` once for each item overlapping `box`.
+    template <typename F>
+    void visit(const Box<N> &box, F &&f) const {
+        const Box<N> range = cells(box);
+        const auto visit_cell = [&](const Pos<N> &pos, const List<ItemRef> &list) {
+            for (const ItemRef &item : list) {
+                const Box<N> item_box = bbox(item);
+                if (item_box.overlaps(box) && cell(max(item_box.min, box.min)) == pos) {
+                    f(item);
+                }
+            }
+        };
+        // Walk the map instead if it has fewer cells than the range
+        U64 num_cells = 1;
+        for (U64 d = 0; d < N && num_cells <= cells_.size(); ++d) {
+            num_cells *= range.shape()[d];
+        }
+        if (num_cells <= cells_.size()) {
+            for (const Pos<N> &pos : range) {
+                if (const List<ItemRef> *list = cells_.get(pos)) {
+                    visit_cell(pos, *list);
+                }
+            }
+        } else {
+            for (const auto &[pos, list] : cells_) {
+                if (range.contains(pos)) {
+                    visit_cell(pos, list);
+                }
+            }
+        }
+    }
+
+    pure List<ItemRef> items_in(const Box<N> &box) const {
+        List<ItemRef> items;
+        visit(box, [&](const ItemRef &item) { items.push_back(item); });
+        return items;
+    }
+
+    Map<ItemRef, std::unique_ptr<Item>, ItemRefHash> items_;
+    Map<Pos<N>, List<ItemRef>> cells_;
+};
+
+} // namespace nvl
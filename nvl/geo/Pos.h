@@ -1,7 +1,11 @@
 #pragma once
 
+#include <concepts>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "nvl/data/Iterator.h"
 #include "nvl/data/Maybe.h"
@@ -14,20 +18,32 @@
 
 namespace nvl {
 
-template <U64 N>
+/// True if every value of integer type `From` can be represented by integer type `To`.
+template <typename From, typename To>
+constexpr bool kLossless = std::in_range<To>(std::numeric_limits<From>::min()) &&
+                           std::in_range<To>(std::numeric_limits<From>::max());
+
+/**
+ * @class Pos
+ * @brief A point in an N-dimensional integer space.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ * @tparam T Type of each coordinate. Defaults to I64; see Pos32 for a compact alternative.
+ */
+template <U64 N, typename T = I64>
 class Pos {
 public:
-    using value_type = I64;
+    using value_type = T;
 
-    struct iterator final : AbstractIteratorCRTP<iterator, I64> {
-        class_tag(Pos<N>::iterator, AbstractIterator<I64>);
+    struct iterator final : AbstractIteratorCRTP<iterator, T> {
+        class_tag(Pos::iterator, AbstractIterator<T>);
 
         template <View Type>
-        static Iterator<I64, Type> begin(const Pos &pos) {
+        static Iterator<T, Type> begin(const Pos &pos) {
             return make_iterator<iterator, Type>(pos, 0);
         }
         template <View Type>
-        static Iterator<I64, Type> end(const Pos &pos) {
+        static Iterator<T, Type> end(const Pos &pos) {
             return make_iterator<iterator, Type>(pos, N);
         }
 
@@ -35,7 +51,7 @@ public:
 
         void increment() override { ++index_; }
 
-        pure const I64 *ptr() override { return &pos_.indices_[index_]; }
+        pure const T *ptr() override { return &pos_.indices_[index_]; }
 
         pure bool operator==(const iterator &rhs) const override { return pos_ == rhs.pos_ && index_ == rhs.index_; }
 
@@ -44,7 +60,7 @@ public:
     };
 
     /// Returns a Pos of rank `N` where all elements are `value`.
-    static constexpr Pos fill(const I64 value) {
+    static constexpr Pos fill(const T value) {
         Pos result;
         for (U64 i = 0; i < N; ++i) {
             result[i] = value;
@@ -53,7 +69,7 @@ public:
     }
 
     /// Returns a Pos of rank `N` where all elements are zero except the one at `i`, which is `x`.
-    static constexpr Pos unit(const U64 i, const I64 x = 1) {
+    static constexpr Pos unit(const U64 i, const T x = 1) {
         ASSERT(i < N, "Index " << i << " is out of bounds [" << 0 << ", " << N << ")");
         Pos result = fill(0);
         result[i] = x;
@@ -69,55 +85,67 @@ public:
     /// Returns a Pos of rank `N` with uninitialized elements.
     explicit constexpr Pos() = default;
 
-    explicit constexpr Pos(I64 a)
+    explicit constexpr Pos(T a)
         requires(N == 1)
         : indices_{a} {}
-    constexpr Pos(I64 a, I64 b)
+    constexpr Pos(T a, T b)
         requires(N == 2)
         : indices_{a, b} {}
-    constexpr Pos(I64 a, I64 b, I64 c)
+    constexpr Pos(T a, T b, T c)
         requires(N == 3)
         : indices_{a, b, c} {}
-    constexpr Pos(I64 a, I64 b, I64 c, I64 d)
+    constexpr Pos(T a, T b, T c, T d)
         requires(N == 4)
         : indices_{a, b, c, d} {}
-    constexpr Pos(I64 a, I64 b, I64 c, I64 d, I64 e)
+    constexpr Pos(T a, T b, T c, T d, T e)
         requires(N == 5)
         : indices_{a, b, c, d, e} {}
 
+    /// Converts a Pos with another coordinate type. Conversions which may overflow must be explicit, and are checked
+    /// in debug builds.
+    template <typename U>
+        requires(!std::same_as<T, U>)
+    explicit(!kLossless<U, T>) constexpr Pos(const Pos<N, U> &pos) {
+        for (U64 i = 0; i < N; ++i) {
+            DEBUG_ASSERT(std::in_range<T>(pos[i]), "Coordinate " << pos[i] << " of " << pos << " overflows "
+                                                                 << sizeof(T) * 8 << "-bit coordinates");
+            indices_[i] = static_cast<T>(pos[i]);
+        }
+    }
+
     /// Implicitly converts this Pos to an integer. Only valid for rank 1.
-    explicit operator I64() const {
+    explicit operator T() const {
         static_assert(N == 1, "Cannot convert Pos of rank > 1 to integer.");
         return indices_[0];
     }
 
-    pure MIterator<I64> begin() { return iterator::template begin<View::kMutable>(*this); }
-    pure MIterator<I64> end() { return iterator::template end<View::kMutable>(*this); }
-    pure Iterator<I64> begin() const { return iterator::template begin<View::kImmutable>(*this); }
-    pure Iterator<I64> end() const { return iterator::template end<View::kImmutable>(*this); }
+    pure MIterator<T> begin() { return iterator::template begin<View::kMutable>(*this); }
+    pure MIterator<T> end() { return iterator::template end<View::kMutable>(*this); }
+    pure Iterator<T> begin() const { return iterator::template begin<View::kImmutable>(*this); }
+    pure Iterator<T> end() const { return iterator::template end<View::kImmutable>(*this); }
 
     /// Returns the rank of this Pos.
     pure constexpr U64 rank() const { return N; }
 
     /// Returns the element at `i` or None if `i` is out of bounds.
-    pure Maybe<I64> get(const U64 i) const { return i < N ? Some(indices_[i]) : None; }
+    pure Maybe<T> get(const U64 i) const { return i < N ? Some(indices_[i]) : None; }
 
     /// Returns the element at `i` or `v` if `i` is out of bounds.
-    pure I64 get_or(const U64 i, const I64 v) const { return i < N ? indices_[i] : v; }
+    pure T get_or(const U64 i, const T v) const { return i < N ? indices_[i] : v; }
 
     /// Returns the element at `i`, asserting that `i` is within bounds.
-    pure constexpr I64 operator[](const U64 i) const {
+    pure constexpr T operator[](const U64 i) const {
         ASSERT(i < N, "Index " << i << " is out of bounds [" << 0 << ", " << N << ")");
         return indices_[i];
     }
     /// Returns a reference to the element at `i`, asserting that `i` is within bounds.
-    pure constexpr I64 &operator[](const U64 i) {
+    pure constexpr T &operator[](const U64 i) {
         ASSERT(i < N, "Index " << i << " is out of bounds [" << 0 << ", " << N << ")");
         return indices_[i];
     }
 
     /// Returns a copy of this Pos with the element at `i` changed to `v`.
-    pure Pos with(const U64 i, I64 v) const {
+    pure constexpr Pos with(const U64 i, T v) const {
         ASSERT(i < N, "Index " << i << " is out of bounds [" << 0 << ", " << N << ")");
         Pos result = *this;
         result.indices_[i] = v;
@@ -125,16 +153,16 @@ public:
     }
 
     /// Returns a copy of this Pos with every element negated.
-    pure Pos operator-() const {
+    pure constexpr Pos operator-() const {
         Pos result = *this;
-        for (I64 &x : result.indices_) {
+        for (T &x : result.indices_) {
             x = -x;
         }
         return result;
     }
 
     /// Returns a new Pos with the result of element-wise multiplication.
-    pure Pos operator*(const Pos &rhs) const {
+    pure constexpr Pos operator*(const Pos &rhs) const {
         Pos result;
         for (U64 i = 0; i < N; ++i) {
             result[i] = indices_[i] * rhs.indices_[i];
@@ -143,7 +171,7 @@ public:
     }
 
     /// Returns a new Pos with the result of element-wise division.
-    pure Pos operator/(const Pos &rhs) const {
+    pure constexpr Pos operator/(const Pos &rhs) const {
         Pos result;
         for (U64 i = 0; i < N; ++i) {
             result[i] = indices_[i] / rhs.indices_[i];
@@ -152,7 +180,7 @@ public:
     }
 
     /// Returns a new Pos with the result of element-wise addition.
-    pure Pos operator+(const Pos &rhs) const {
+    pure constexpr Pos operator+(const Pos &rhs) const {
         Pos result;
         for (U64 i = 0; i < N; ++i) {
             result[i] = indices_[i] + rhs.indices_[i];
@@ -161,7 +189,7 @@ public:
     }
 
     /// Returns a new Pos with the result of element-wise subtraction.
-    pure Pos operator-(const Pos &rhs) const {
+    pure constexpr Pos operator-(const Pos &rhs) const {
         Pos result;
         for (U64 i = 0; i < N; ++i) {
             result[i] = indices_[i] - rhs.indices_[i];
@@ -170,36 +198,36 @@ public:
     }
 
     /// Returns a new Pos with the result of element-wise multiplication.
-    pure Pos operator*(const I64 rhs) const {
+    pure constexpr Pos operator*(const T rhs) const {
         Pos result = *this;
-        for (I64 &x : result.indices_) {
+        for (T &x : result.indices_) {
             x *= rhs;
         }
         return result;
     }
 
     /// Returns a new Pos with the result of element-wise division.
-    pure Pos operator/(const I64 rhs) const {
+    pure constexpr Pos operator/(const T rhs) const {
         Pos result = *this;
-        for (I64 &x : result.indices_) {
+        for (T &x : result.indices_) {
             x /= rhs;
         }
         return result;
     }
 
     /// Returns a new Pos with the result of element-wise addition.
-    pure Pos operator+(const I64 rhs) const {
+    pure constexpr Pos operator+(const T rhs) const {
         Pos result = *this;
-        for (I64 &x : result.indices_) {
+        for (T &x : result.indices_) {
             x += rhs;
         }
         return result;
     }
 
     /// Returns a new Pos with the result of element-wise subtraction.
-    pure Pos operator-(const I64 rhs) const {
+    pure constexpr Pos operator-(const T rhs) const {
         Pos result = *this;
-        for (I64 &x : result.indices_) {
+        for (T &x : result.indices_) {
             x -= rhs;
         }
         return result;
@@ -215,7 +243,7 @@ public:
         return result;
     }
 
-    pure Pos grid_max(const I64 grid) const {
+    pure Pos grid_max(const T grid) const {
         Pos result;
         for (U64 i = 0; i < N; i++) {
             result[i] = nvl::grid_max(indices_[i], grid);
@@ -233,7 +261,7 @@ public:
         return result;
     }
 
-    pure Pos grid_min(const I64 grid) const {
+    pure Pos grid_min(const T grid) const {
         Pos result;
         for (U64 i = 0; i < N; i++) {
             result[i] = nvl::grid_min(indices_[i], grid);
@@ -242,7 +270,7 @@ public:
     }
 
     /// Returns true if the two Pos instances have identical elements.
-    pure bool operator==(const Pos &rhs) const {
+    pure constexpr bool operator==(const Pos &rhs) const {
         for (U64 i = 0; i < N; ++i) {
             if (indices_[i] != rhs.indices_[i]) {
                 return false;
@@ -252,10 +280,10 @@ public:
     }
 
     /// Returns true if the two Pos instances do not have identical elements.
-    pure bool operator!=(const Pos &rhs) const { return !(*this == rhs); }
+    pure constexpr bool operator!=(const Pos &rhs) const { return !(*this == rhs); }
 
     /// Returns true if every element is strictly less than the corresponding element in `rhs`.
-    pure bool all_lt(const Pos &rhs) const {
+    pure constexpr bool all_lt(const Pos &rhs) const {
         for (U64 i = 0; i < N; ++i) {
             if (indices_[i] >= rhs.indices_[i]) {
                 return false;
@@ -265,7 +293,7 @@ public:
     }
 
     /// Returns true if every element is less than or equal to the corresponding element in `rhs`.
-    pure bool all_lte(const Pos &rhs) const {
+    pure constexpr bool all_lte(const Pos &rhs) const {
         for (U64 i = 0; i < N; ++i) {
             if (indices_[i] > rhs.indices_[i]) {
                 return false;
@@ -275,15 +303,15 @@ public:
     }
 
     /// Returns true if every element is greater than the corresponding element in `rhs`.
-    pure bool all_gt(const Pos &rhs) const { return rhs.all_lt(*this); }
+    pure constexpr bool all_gt(const Pos &rhs) const { return rhs.all_lt(*this); }
 
     /// Returns true if every element is greater than or equal to the corresponding element in `rhs`.
-    pure bool all_gte(const Pos &rhs) const { return rhs.all_lte(*this); }
+    pure constexpr bool all_gte(const Pos &rhs) const { return rhs.all_lte(*this); }
 
     pure I64 manhattan_dist(const Pos &rhs) const {
         I64 result = 0;
         for (U64 i = 0; i < N; ++i) {
-            result += std::abs(indices_[i] - rhs.indices_[i]);
+            result += std::abs(static_cast<I64>(indices_[i]) - rhs.indices_[i]);
         }
         return result;
     }
@@ -307,14 +335,14 @@ public:
 
     pure I64 product() const {
         I64 product = 1;
-        for (const I64 x : indices_)
+        for (const T x : indices_)
             product *= x;
         return product;
     }
 
     pure I64 sum() const {
         I64 sum = 0;
-        for (const I64 x : indices_)
+        for (const T x : indices_)
             sum += x;
         return sum;
     }
@@ -352,26 +380,26 @@ public:
         }
         return *this;
     }
-    Pos &operator*=(const I64 rhs) {
-        for (I64 &x : indices_) {
+    Pos &operator*=(const T rhs) {
+        for (T &x : indices_) {
             x *= rhs;
         }
         return *this;
     }
-    Pos &operator/=(const I64 rhs) {
-        for (I64 &x : indices_) {
+    Pos &operator/=(const T rhs) {
+        for (T &x : indices_) {
             x /= rhs;
         }
         return *this;
     }
-    Pos &operator+=(const I64 rhs) {
-        for (I64 &x : indices_) {
+    Pos &operator+=(const T rhs) {
+        for (T &x : indices_) {
             x += rhs;
         }
         return *this;
     }
-    Pos &operator-=(const I64 rhs) {
-        for (I64 &x : indices_) {
+    Pos &operator-=(const T rhs) {
+        for (T &x : indices_) {
             x -= rhs;
         }
         return *this;
@@ -389,58 +417,62 @@ public:
 
 private:
     friend struct std::hash<Pos>;
-    I64 indices_[N];
+    T indices_[N];
 };
 
-template <U64 N>
-const Pos<N> Pos<N>::zero = Pos::fill(0);
+template <U64 N, typename T>
+const Pos<N, T> Pos<N, T>::zero = Pos::fill(0);
 
-template <U64 N>
-const Pos<N> Pos<N>::ones = Pos::fill(1);
+template <U64 N, typename T>
+const Pos<N, T> Pos<N, T>::ones = Pos::fill(1);
 
+/// A Pos with compact 32-bit coordinates, e.g. for storing many positions which are known to be within range.
 template <U64 N>
-Pos<N> min(const Pos<N> &a, const Pos<N> &b) {
-    Pos<N> result;
+using Pos32 = Pos<N, I32>;
+
+template <U64 N, typename T>
+constexpr Pos<N, T> min(const Pos<N, T> &a, const Pos<N, T> &b) {
+    Pos<N, T> result;
     for (U64 i = 0; i < N; ++i) {
         result[i] = std::min(a[i], b[i]);
     }
     return result;
 }
 
-template <U64 N>
-Pos<N> max(const Pos<N> &a, const Pos<N> &b) {
-    Pos<N> result;
+template <U64 N, typename T>
+constexpr Pos<N, T> max(const Pos<N, T> &a, const Pos<N, T> &b) {
+    Pos<N, T> result;
     for (U64 i = 0; i < N; ++i) {
         result[i] = std::max(a[i], b[i]);
     }
     return result;
 }
 
-template <U64 N>
-Pos<N> operator*(I64 a, const Pos<N> &b) {
+template <U64 N, typename T>
+Pos<N, T> operator*(std::type_identity_t<T> a, const Pos<N, T> &b) {
     return b * a;
 }
-template <U64 N>
-Pos<N> operator/(I64 a, const Pos<N> &b) {
-    return Pos<N>::fill(a) / b;
+template <U64 N, typename T>
+Pos<N, T> operator/(std::type_identity_t<T> a, const Pos<N, T> &b) {
+    return Pos<N, T>::fill(a) / b;
 }
-template <U64 N>
-Pos<N> operator+(I64 a, const Pos<N> &b) {
+template <U64 N, typename T>
+Pos<N, T> operator+(std::type_identity_t<T> a, const Pos<N, T> &b) {
     return b + a;
 }
-template <U64 N>
-Pos<N> operator-(I64 a, const Pos<N> &b) {
+template <U64 N, typename T>
+Pos<N, T> operator-(std::type_identity_t<T> a, const Pos<N, T> &b) {
     return -b + a;
 }
 
-template <U64 N>
-std::ostream &operator<<(std::ostream &os, const Pos<N> &a) {
+template <U64 N, typename T>
+std::ostream &operator<<(std::ostream &os, const Pos<N, T> &a) {
     return os << a.to_string();
 }
 
 } // namespace nvl
 
-template <U64 N>
-struct std::hash<nvl::Pos<N>> {
-    pure U64 operator()(const nvl::Pos<N> &a) const noexcept { return nvl::sip_hash(a.indices_); }
-};
+template <U64 N, typename T>
+struct std::hash<nvl::Pos<N, T>> {
+    pure U64 operator()(const nvl::Pos<N, T> &a) const noexcept { return nvl::sip_hash(a.indices_); }
+};
\ No newline at end of file
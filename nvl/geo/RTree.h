@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 #include "nvl/data/List.h"
 #include "nvl/data/Map.h"
@@ -9,10 +14,14 @@
 #include "nvl/data/Range.h"
 #include "nvl/data/Ref.h"
 #include "nvl/data/Set.h"
+#include "nvl/data/Shared.h"
 #include "nvl/data/UnionFind.h"
 #include "nvl/geo/Box.h"
+#include "nvl/geo/BoxArray.h"
+#include "nvl/geo/CellKeys.h"
 #include "nvl/geo/HasBBox.h"
 #include "nvl/geo/Pos.h"
+#include "nvl/geo/Summary.h"
 #include "nvl/io/IO.h"
 #include "nvl/macros/Abstract.h"
 #include "nvl/macros/Aliases.h"
@@ -24,11 +33,26 @@ namespace nvl {
 
 namespace detail {
 
+/**
+ * @struct Aggregate
+ * @brief Number and combined summary of a set of items (see RTree).
+ */
+template <typename Summary>
+struct Aggregate {
+    void add(const Aggregate &rhs) {
+        count += rhs.count;
+        value = Summary::combine(value, rhs.value);
+    }
+
+    U64 count = 0;
+    typename Summary::Value value = Summary::identity();
+};
+
 /**
  * @class Node
  * @brief A node within an RTree.
  */
-template <U64 N, typename ItemRef>
+template <U64 N, typename ItemRef, typename Summary = NoSummary, typename Keys = PosKeys<N>>
 struct Node {
     struct Parent {
         Node *node; // The parent node
@@ -40,6 +64,7 @@ struct Node {
         Kind kind = kList;
         Node *node = nullptr;
         List<ItemRef> list;
+        Aggregate<Summary> summary; // Items owned by this entry (see RTree)
     };
 
     Node() = default;
@@ -49,19 +74,24 @@ struct Node {
     pure bool operator==(const Node &rhs) const { return id == rhs.id; }
     pure bool operator!=(const Node &rhs) const { return !(*this == rhs); }
 
-    pure Entry *get(const Pos<N> &pos) const { return map.get(pos.grid_min(grid)); }
+    pure Entry *get(const Pos<N> &pos) const { return map.get(key(pos)); }
+
+    /// Returns the key of the cell containing `pos`, and the minimum corner of the cell with `key`.
+    pure typename Keys::Key key(const Pos<N> &pos) const { return Keys::key(pos, grid); }
+    pure Pos<N> pos(const typename Keys::Key &key) const { return Keys::pos(key, grid); }
 
-    pure Range<Pos<N>> pos_iter(const Box<N> &vol) const { return vol.clamp(grid).pos_iter(Pos<N>::fill(grid)); }
+    pure Range<Pos<N>> pos_iter(const Box<N> &vol) const { return Keys::cells_in(vol, grid); }
 
     U64 id = -1;
     Maybe<Parent> parent;
     I64 grid = -1;
-    Map<Pos<N>, Entry> map;
+    Map<typename Keys::Key, Entry> map;
+    Aggregate<Summary> summary; // Items owned by all entries, except in the root
 };
 
-template <U64 N, typename ItemRef>
+template <U64 N, typename ItemRef, typename Summary = NoSummary, typename Keys = PosKeys<N>>
 struct Work {
-    using Node = Node<N, ItemRef>;
+    using Node = Node<N, ItemRef, Summary, Keys>;
 
     explicit Work(Node *node, const Box<N> &volume) : node(node), vol(volume) {}
 
@@ -75,9 +105,9 @@ struct Work {
     Once<Pos<N>> pair_range;  // 2) Iterating within a node - (node, pos) pairs
 };
 
-template <U64 N, typename ItemRef>
+template <U64 N, typename ItemRef, typename Summary = NoSummary, typename Keys = PosKeys<N>>
 struct PreorderWork {
-    using Node = Node<N, ItemRef>;
+    using Node = Node<N, ItemRef, Summary, Keys>;
 
     PreorderWork(Node *node, const U64 depth) : node(node), depth(depth) {
         ASSERT(node->parent.has_value(), "No parent defined for node #" << node->id);
@@ -105,15 +135,32 @@ struct PreorderWork {
  * @tparam kMaxEntries Maximum number of entries per node. Defaults to 10.
  * @tparam kGridExpMin Minimum node grid size (2 ^ min_grid_exp). Defaults to 2.
  * @tparam kGridExpMax Initial grid size of the root. (2 ^ root_grid_exp). Defaults to 10.
+ * @tparam Summary Policy for summaries of the items in each node (see Summary.h). Defaults to no summaries.
+ * @tparam Keys Policy for keying the cells of each node (see CellKeys.h). Defaults to keying by position.
+ *
+ * With a summary policy, each entry keeps the number and combined summary of the items it owns, and each node those of
+ * all its entries. An item is owned by the one leaf entry whose cell contains its minimum corner, even though it is
+ * listed in every cell it overlaps, so that no item is counted twice. Summaries are updated as items are inserted,
+ * removed, and moved, and let queries such as count_in and any_in skip whole cells without visiting their items.
+ *
+ * Alternatively, a tree may use a loose layout (see Layout::kLoose), where each item is listed exactly once, in the cell
+ * of the finest grid at least as large as the item which contains its minimum corner. An item listed in the cell at
+ * `key` of a grid `g` then lies within the loose cell [key, key + 2g - 2], so queries look up the few cells of each grid
+ * whose loose cells overlap the query volume, and need not deduplicate items. This suits large numbers of items which
+ * rarely move, such as terrain, which would otherwise be listed in every cell they overlap. The loose layout keeps no
+ * nodes; instead, each loose cell keeps the summary of the items listed in it, which queries use for loose cells
+ * entirely within the query volume.
  */
 template <U64 N, typename Item, typename ItemRef = Ref<Item>, U64 kMaxEntries = 10, U64 kGridExpMin = 2,
-          U64 kGridExpMax = 10>
+          U64 kGridExpMax = 10, typename Summary = NoSummary, typename Keys = PosKeys<N>>
     requires trait::HasBBox<Item>
 class RTree {
 public:
-    using PreorderWork = detail::PreorderWork<N, ItemRef>;
-    using Work = detail::Work<N, ItemRef>;
-    using Node = detail::Node<N, ItemRef>;
+    using PreorderWork = detail::PreorderWork<N, ItemRef, Summary, Keys>;
+    using Work = detail::Work<N, ItemRef, Summary, Keys>;
+    using Node = detail::Node<N, ItemRef, Summary, Keys>;
+    using Aggregate = detail::Aggregate<Summary>;
+    static constexpr bool kSummarized = !std::is_same_v<Summary, NoSummary>;
     using ItemRefHash = PointerHash<ItemRef>; // Hashing is done based on pointer, not value
     using Component = typename UnionFind<ItemRef, ItemRefHash>::Group;
 
@@ -122,6 +169,68 @@ public:
         Pos<N> pos;
     };
 
+    /// Layout of items within the tree (see RTree).
+    enum class Layout {
+        kGrid, // Items are listed in every cell of the hierarchical grid they overlap
+        kLoose // Items are listed once, in the loose cell of the finest grid they fit in
+    };
+
+    /// Number of possible node levels, from the root (grid_max) down to nodes with grid_min.
+    static constexpr U64 kLevels = kGridExpMax - kGridExpMin + 1;
+
+    /**
+     * @struct Stats
+     * @brief Structural summary of an RTree, used for tuning kMaxEntries, kGridExpMin, and kGridExpMax.
+     */
+    struct Stats {
+        static constexpr U64 kMaxListLength = 2 * kMaxEntries; // Last bucket of the list length histogram
+
+        U64 items = 0;
+        U64 nodes = 0;
+        U64 depth = 0;
+        std::array<U64, kLevels> nodes_per_level{};   // Number of nodes at each level (0 is the root)
+        std::array<U64, kLevels> entries_per_level{}; // Number of entries (lists or child nodes) at each level
+        U64 list_entries = 0;                         // Entries holding a list of items
+        U64 node_entries = 0;                         // Entries pointing to a child node
+        U64 empty_entries = 0;                        // List entries with no items
+        U64 empty_nodes = 0;                          // Non-root nodes with no entries
+        U64 references = 0;                           // Total item references across all lists
+        std::array<U64, kMaxListLength + 1> list_lengths{}; // Histogram of list lengths (last bucket is >= max)
+        U64 memory = 0;                               // Approximate heap footprint in bytes
+        U64 queries = 0;                              // Number of window queries counted
+        U64 cells_visited = 0;                        // Number of (node, pos) cells examined by counted queries
+
+        /// Returns the average number of cells each item is referenced from.
+        pure F64 duplication() const { return items > 0 ? static_cast<F64>(references) / items : 0; }
+
+        /// Returns the average number of cells visited per counted query.
+        pure F64 cells_per_query() const { return queries > 0 ? static_cast<F64>(cells_visited) / queries : 0; }
+
+        friend std::ostream &operator<<(std::ostream &os, const Stats &stats) {
+            os << "items: " << stats.items << ", nodes: " << stats.nodes << ", depth: " << stats.depth << std::endl;
+            for (U64 level = 0; level < stats.depth; ++level) {
+                os << "  level " << level << " (grid " << (grid_max >> level) << "): " << stats.nodes_per_level[level]
+                   << " nodes, " << stats.entries_per_level[level] << " entries" << std::endl;
+            }
+            os << "entries: " << stats.list_entries << " lists, " << stats.node_entries << " nodes, "
+               << stats.empty_entries << " empty lists, " << stats.empty_nodes << " empty nodes" << std::endl;
+            os << "duplication: " << stats.duplication() << " cells/item (" << stats.references << " references)"
+               << std::endl;
+            os << "list lengths:";
+            for (U64 i = 0; i <= kMaxListLength; ++i) {
+                if (stats.list_lengths[i] > 0) {
+                    os << " " << i << (i == kMaxListLength ? "+" : "") << ":" << stats.list_lengths[i];
+                }
+            }
+            os << std::endl;
+            os << "memory: ~" << stats.memory << " bytes" << std::endl;
+            if (stats.queries > 0) {
+                os << "queries: " << stats.queries << " (" << stats.cells_per_query() << " cells/query)" << std::endl;
+            }
+            return os;
+        }
+    };
+
     enum class Traversal {
         kPoints,  // All possible points in existing nodes
         kEntries, // All existing entries
@@ -134,6 +243,9 @@ public:
         template <View Type = View::kImmutable>
         static Iterator<Value, Type> begin(const RTree &tree, const Box<N> &box) {
             std::shared_ptr<Concrete> iter = std::make_shared<Concrete>(&tree, box);
+            if constexpr (mode == Traversal::kItems) {
+                tree.queries_ += tree.count_queries_;
+            }
             if (tree.root_ != nullptr) {
                 iter->worklist.emplace_back(tree.root_, box);
                 iter->increment();
@@ -162,6 +274,9 @@ public:
             }
 
             const Pos<N> &pos = current.pos();
+            if constexpr (mode == Traversal::kItems) {
+                tree->cells_visited_ += tree->count_queries_;
+            }
 
             if (auto *entry = node->get(pos)) {
                 if (entry->kind == Node::Entry::kList) {
@@ -334,6 +449,7 @@ public:
     static constexpr I64 grid_max = 0x1 << kGridExpMax;
 
     explicit RTree() : root_(next_node(None, grid_max, {})) {}
+    explicit RTree(const Layout layout) : RTree() { layout_ = layout; }
 
     RTree(std::initializer_list<Item> items) : RTree() {
         for (const auto &item : items) {
@@ -373,6 +489,29 @@ public:
         return take_over(std::move(item), box);
     }
 
+    /// Takes ownership of all of the given items at once, e.g. when loading a saved world.
+    /// Returns references to the items held by the tree, in the same order.
+    /// If the items are at least as many as those already in the tree, the tree is built once all items are held
+    /// (see rebuild), rather than growing and splitting nodes as each item is added.
+    List<ItemRef> take(std::vector<std::unique_ptr<Item>> items) {
+        const bool bulk = !items.empty() && items.size() >= size();
+        List<ItemRef> refs;
+        for (std::unique_ptr<Item> &item : items) {
+            if (!bulk) {
+                refs.push_back(take(std::move(item)));
+                continue;
+            }
+            const U64 id = ++item_id_;
+            ItemRef ref((items_[id] = std::move(item)).get());
+            item_ids_[ref] = id;
+            refs.push_back(ref);
+        }
+        if (bulk) {
+            rebuild();
+        }
+        return refs;
+    }
+
     /// Constructs a new item and adds it to this tree.
     /// Returns a reference to the new item held by the tree.
     template <typename T = Item, typename... Args>
@@ -389,6 +528,15 @@ public:
         return *this;
     }
 
+    /// Removes the matching item from the tree and returns ownership of it, or nullptr if it does not exist.
+    std::unique_ptr<Item> release(const ItemRef &item) {
+        auto pair = get_item(item);
+        return_if(!pair.has_value(), nullptr);
+        std::unique_ptr<Item> result = std::move(items_[pair->first]);
+        remove_over(item, result->bbox(), true);
+        return result;
+    }
+
     /// Registers the matching item as having moved from the previous volume `prev` to its current volume.
     /// Does nothing if no matching item exists in the tree.
     RTree &move(const ItemRef &item, const Box<N> &prev) { return move(item, bbox(item), prev); }
@@ -405,10 +553,108 @@ public:
 
     /// Returns an iterable range over all unique stored items in the given volume.
     pure MRange<ItemRef> operator[](const Pos<N> &pos) { return operator[](Box<N>::unit(pos)); }
-    pure MRange<ItemRef> operator[](const Box<N> &box) { return make_mrange<window_iterator>(*this, box); }
+    pure MRange<ItemRef> operator[](const Box<N> &box) {
+        return_if(loose(), shared<ItemRef, View::kMutable>(loose_items(box)));
+        return make_mrange<window_iterator>(*this, box);
+    }
 
     pure Range<ItemRef> operator[](const Pos<N> &pos) const { return operator[](Box<N>::unit(pos)); }
-    pure Range<ItemRef> operator[](const Box<N> &box) const { return make_range<window_iterator>(*this, box); }
+    pure Range<ItemRef> operator[](const Box<N> &box) const {
+        return_if(loose(), shared(loose_items(box)));
+        return make_range<window_iterator>(*this, box);
+    }
+
+    /// Finds the unique stored items in each of the given volumes, calling `f(i, item)` once for each item overlapping
+    /// the i-th volume. Equivalent to querying each volume with operator[], but the volumes are sorted spatially and
+    /// traversed together, so each node is visited once for all volumes which overlap it rather than once per volume.
+    /// Items are reported grouped by the cell they were found in, not by volume. In the loose layout, the loose cells
+    /// of each grid are likewise visited once for all volumes which may overlap them.
+    template <typename F>
+    void query_many(const Range<Box<N>> &boxes, F &&f) const {
+        const List<Box<N>> queries(boxes);
+        if (loose()) {
+            loose_query_many(queries, f);
+            return;
+        }
+        return_if(queries.empty() || root_ == nullptr);
+        queries_ += count_queries_ * queries.size();
+
+        // Sort by the root cell containing each volume's minimum corner, then by the corner itself
+        std::vector<U64> order(queries.size());
+        std::iota(order.begin(), order.end(), 0);
+        const auto less = [](const Pos<N> &a, const Pos<N> &b) {
+            for (U64 d = 0; d < N; ++d) {
+                return_if(a[d] != b[d], a[d] < b[d]);
+            }
+            return false;
+        };
+        std::sort(order.begin(), order.end(), [&](const U64 a, const U64 b) {
+            const Pos<N> cell_a = queries[a].min.grid_min(grid_max);
+            const Pos<N> cell_b = queries[b].min.grid_min(grid_max);
+            return cell_a != cell_b ? less(cell_a, cell_b) : less(queries[a].min, queries[b].min);
+        });
+
+        struct Batch {
+            const Node *node;
+            List<U64> queries; // Indices of the volumes overlapping the node
+        };
+        std::vector<Set<ItemRef, ItemRefHash>> visited(queries.size());
+        BoxArray<N> item_boxes; // Boxes of the items in the current cell, when it is shared by several volumes
+        List<Batch> worklist;
+        worklist.push_back({root_, List<U64>(order.begin(), order.end())});
+        while (!worklist.empty()) {
+            const Batch batch = std::move(worklist.back());
+            worklist.pop_back();
+            const Node *node = batch.node;
+
+            // Group the volumes by the cells of this node they overlap
+            Map<Pos<N>, List<U64>> cells;
+            for (const U64 i : batch.queries) {
+                Maybe<Box<N>> vol = queries[i];
+                if (node->parent.has_value()) {
+                    vol = node->parent->box.intersect(queries[i]);
+                }
+                if (vol.has_value()) {
+                    for (const Pos<N> &pos : node->pos_iter(*vol)) {
+                        if (node->get(pos) != nullptr) {
+                            cells[pos].push_back(i);
+                        }
+                    }
+                }
+            }
+
+            for (const auto &[pos, group] : cells) {
+                cells_visited_ += count_queries_;
+                const typename Node::Entry &entry = *node->get(pos);
+                if (entry.kind == Node::Entry::kNode) {
+                    worklist.push_back({entry.node, group});
+                    continue;
+                }
+                if (group.size() == 1) {
+                    const U64 i = group.front();
+                    for (const ItemRef &item : entry.list) {
+                        if (bbox(item).overlaps(queries[i]) && visited[i].insert(item).second) {
+                            f(i, item);
+                        }
+                    }
+                    continue;
+                }
+                // Gather the item boxes once, then test them against each volume together
+                item_boxes.clear();
+                for (const ItemRef &item : entry.list) {
+                    item_boxes.push_back(bbox(item));
+                }
+                for (const U64 i : group) {
+                    item_boxes.overlapping(queries[i], [&](const U64 j) {
+                        const ItemRef &item = entry.list[j];
+                        if (visited[i].insert(item).second) {
+                            f(i, item);
+                        }
+                    });
+                }
+            }
+        }
+    }
 
     /// Returns a Range for unordered iteration over all items in this tree.
     pure MRange<ItemRef> items() { return {begin(), end()}; }
@@ -423,20 +669,114 @@ public:
     /// Returns true if this item is contained within the tree.
     pure bool has(const ItemRef &item) const { return item_ids_.has(item); }
 
+    /// Calls `f(a, b)` once for each pair of an item `a` in this tree and an item `b` in `other` whose volumes are
+    /// within `dist` of each other in every dimension, i.e. where `b` overlaps `a` widened by `dist`. A `dist` of 0
+    /// finds overlapping pairs, and 1 also finds adjacent pairs. Both trees share the same grid, so the cells of both
+    /// are walked together once rather than querying `other` for every item in this tree. If either tree uses the loose
+    /// layout, `other` is instead queried for all items in this tree at once (see query_many).
+    template <typename F>
+    void join(const RTree &other, const I64 dist, F &&f) const {
+        if (loose() || other.loose()) {
+            List<ItemRef> refs;
+            List<Box<N>> boxes;
+            for (const std::unique_ptr<Item> &item : items_.values()) {
+                refs.emplace_back(item.get());
+                boxes.push_back(bbox(refs.back()).widened(dist));
+            }
+            other.query_many(boxes.range(), [&](const U64 i, const ItemRef &b) { f(refs[i], b); });
+            return;
+        }
+        for (const auto &[key, entry] : root_->map) {
+            const Pos<N> pos = root_->pos(key);
+            const Box<N> cell(pos, pos + grid_max - 1);
+            for (const Pos<N> &other_pos : other.root_->pos_iter(cell.widened(dist))) {
+                if (const auto *other_entry = other.root_->get(other_pos)) {
+                    join_entries(entry, cell, *other_entry, Box<N>(other_pos, other_pos + grid_max - 1), dist, f);
+                }
+            }
+        }
+    }
+
+    /// Calls `f(a, b)` once for each unordered pair of distinct items in this tree whose volumes are within `dist` of
+    /// each other (see join).
+    template <typename F>
+    void pairs_within(const I64 dist, F &&f) const {
+        join(*this, dist, [&](const ItemRef &a, const ItemRef &b) {
+            if (a.ptr() < b.ptr()) {
+                f(a, b);
+            }
+        });
+    }
+
+    /// Returns the number of unique items overlapping `box`.
+    /// With a summary policy, cells entirely within the box are counted from their summaries.
+    pure U64 count_in(const Box<N> &box) const {
+        if constexpr (kSummarized) {
+            return summarize(box).count;
+        } else {
+            U64 count = 0;
+            for (const ItemRef &_ : (*this)[box]) {
+                count += 1;
+            }
+            return count;
+        }
+    }
+
+    /// Returns the combined summary of all unique items overlapping `box`.
+    pure typename Summary::Value summary(const Box<N> &box) const
+        requires kSummarized
+    {
+        return summarize(box).value;
+    }
+
+    /// Returns true if the summary of any item overlapping `box` satisfies `pred`. The predicate must hold for a
+    /// combined summary if and only if it holds for one of the summaries combined (e.g. testing for a flag in a union
+    /// of flags, or a bound on a bounding box), so that cells can be ruled in or out by their summaries alone.
+    template <typename Pred>
+    pure bool any_in(const Box<N> &box, Pred &&pred) const
+        requires kSummarized
+    {
+        if (loose()) {
+            bool found = false;
+            for (const auto &[grid, cells] : loose_) {
+                loose_cells(grid, cells, box, [&](const Pos<N> &key, const LooseCell &cell) {
+                    return_if(found || !pred(cell.summary.value));
+                    if (contains(box, loose_extent(grid, key))) {
+                        found = true;
+                        return;
+                    }
+                    for (const ItemRef &item : cell.list) {
+                        found = found || (bbox(item).overlaps(box) && pred(aggregate(item).value));
+                    }
+                });
+            }
+            return found;
+        }
+        for (const Pos<N> &pos : root_->pos_iter(box)) {
+            if (const auto *entry = root_->get(pos)) {
+                return_if(any_in(*entry, Box<N>(pos, pos + grid_max - 1), box, pred), true);
+            }
+        }
+        return false;
+    }
+
     /// Returns the connected components in this tree.
     List<Component> components() {
         UnionFind<ItemRef, ItemRefHash> components;
-        for (const std::unique_ptr<Item> &a : items_.values()) {
-            ItemRef a_ref(a.get());
-            bool had_neighbors = false;
-            for (const Edge<N> &edge : a->bbox().edges()) {
-                for (const ItemRef &b : (*this)[edge.bbox()]) {
-                    had_neighbors = true;
-                    components.add(a_ref, b); // Adds neighboring boxes to the same component
-                }
+        // Items are neighbors if either overlaps one of the other's edges, so items touching diagonally are not
+        const auto touches = [](const Box<N> &a, const Box<N> &b) {
+            const auto edges = a.edges();
+            return std::any_of(edges.begin(), edges.end(), [&](const Edge<N> &edge) { return edge.box.overlaps(b); });
+        };
+        pairs_within(1, [&](const ItemRef &a, const ItemRef &b) {
+            if (touches(bbox(a), bbox(b)) || touches(bbox(b), bbox(a))) {
+                components.add(a, b); // Adds neighboring boxes to the same component
             }
-            // Add this item to its own component if it had no neighbors
-            if (!had_neighbors) {
+        });
+        // Add each item without neighbors to its own component
+        for (const std::unique_ptr<Item> &a : items_.values()) {
+            const ItemRef a_ref(a.get());
+            if (!components.has(a_ref)) {
                 components.add(a_ref);
             }
         }
@@ -458,6 +798,10 @@ public:
     /// Returns the total number of distinct items stored in this tree.
     pure U64 size() const { return items_.size(); }
 
+    /// Returns the layout of items within this tree.
+    pure Layout layout() const { return layout_; }
+    pure bool loose() const { return layout_ == Layout::kLoose; }
+
     /// Returns the total number of nodes in this tree.
     pure U64 nodes() const { return nodes_.size(); }
 
@@ -466,12 +810,69 @@ public:
 
     /// Returns the maximum depth, in nodes, of this tree.
     pure U64 depth() const {
-        const U64 root_grid = root_->grid;
-        U64 min_grid = root_grid;
-        for (auto &[_, node] : nodes_) {
-            min_grid = (node.grid < min_grid) ? node.grid : min_grid;
+        for (U64 level = kLevels; level > 0; --level) {
+            return_if(level_nodes_[level - 1] > 0, level);
         }
-        return ceil_log2(root_grid) - ceil_log2(min_grid) + 1;
+        return 0;
+    }
+
+    /// Enables or disables counting the number of cells visited by window queries (operator[]).
+    /// Counts are reported in stats() and reset when counting is enabled.
+    void count_queries(const bool enable) {
+        count_queries_ = enable;
+        if (enable) {
+            queries_ = 0;
+            cells_visited_ = 0;
+        }
+    }
+
+    /// Returns a summary of the structure of this tree.
+    pure Stats stats() const {
+        using MapEntry = std::pair<const typename Keys::Key, typename Node::Entry>;
+        // Approximation of per-element overhead in std::unordered_map: a node with a next pointer and cached hash,
+        // plus one bucket pointer.
+        constexpr U64 kHashOverhead = 3 * sizeof(void *);
+
+        Stats stats;
+        stats.items = size();
+        stats.nodes = nodes();
+        stats.depth = depth();
+        stats.queries = queries_;
+        stats.cells_visited = cells_visited_;
+        stats.memory += items_.size() * (sizeof(Item) + sizeof(std::pair<const U64, std::unique_ptr<Item>>));
+        stats.memory += item_ids_.size() * sizeof(std::pair<const ItemRef, U64>);
+        stats.memory += (items_.size() + item_ids_.size()) * kHashOverhead;
+        for (const auto &[_, node] : nodes_) {
+            const U64 level = this->level(node.grid);
+            stats.nodes_per_level[level] += 1;
+            stats.entries_per_level[level] += node.map.size();
+            stats.empty_nodes += (node.map.empty() && node.parent.has_value());
+            stats.memory += sizeof(std::pair<const U64, Node>) + kHashOverhead;
+            stats.memory += node.map.size() * (sizeof(MapEntry) + kHashOverhead);
+            for (const auto &[_, entry] : node.map) {
+                if (entry.kind == Node::Entry::kList) {
+                    const U64 length = entry.list.size();
+                    stats.list_entries += 1;
+                    stats.empty_entries += (length == 0);
+                    stats.references += length;
+                    stats.list_lengths[std::min(length, Stats::kMaxListLength)] += 1;
+                    stats.memory += length * sizeof(ItemRef);
+                } else {
+                    stats.node_entries += 1;
+                }
+            }
+        }
+        for (const auto &[_, cells] : loose_) {
+            stats.memory += sizeof(std::pair<const I64, LooseCells>) + kHashOverhead;
+            stats.memory += cells.size() * (sizeof(std::pair<const Pos<N>, LooseCell>) + kHashOverhead);
+            for (const auto &[_, cell] : cells) {
+                stats.list_entries += 1;
+                stats.references += cell.list.size();
+                stats.list_lengths[std::min<U64>(cell.list.size(), Stats::kMaxListLength)] += 1;
+                stats.memory += cell.list.size() * sizeof(ItemRef);
+            }
+        }
+        return stats;
     }
 
     void clear() {
@@ -480,15 +881,42 @@ public:
         item_id_ = 0;
         items_.clear();
         nodes_.clear();
+        level_nodes_.fill(0);
         item_ids_.clear();
         garbage_.clear();
+        loose_.clear();
+        root_ = next_node(None, grid_max, {});
+    }
+
+    /// Rebuilds all nodes from the current volumes of the items in this tree.
+    /// This collapses nodes which were split while the tree held more items, and shrinks the bounding box after
+    /// removals, at the cost of re-inserting every item.
+    void rebuild() {
+        bbox_ = None;
+        nodes_.clear();
+        level_nodes_.fill(0);
+        garbage_.clear();
+        loose_.clear();
         root_ = next_node(None, grid_max, {});
+        for (const std::unique_ptr<Item> &item : items_.values()) {
+            const Box<N> box = item->bbox();
+            bbox_ = bbox_ ? bounding_box(*bbox_, box) : box;
+            populate_over(ItemRef(item.get()), box);
+        }
     }
 
     /// Dumps a string representation of this tree to stdout.
     void dump() const {
         const auto bounds = bbox_.value_or(Box<N>::unit(Pos<N>::fill(1)));
         std::cout << "[[RTree with bounds " << bounds << "]]" << std::endl;
+        for (const auto &[grid, cells] : loose_) {
+            for (const auto &[key, cell] : cells) {
+                std::cout << "[loose " << grid << "][" << loose_extent(grid, key) << "]:" << std::endl;
+                for (const auto item : cell.list) {
+                    std::cout << ">> " << item << std::endl;
+                }
+            }
+        }
 
         List<PreorderWork> worklist;
         worklist.emplace_back(root_, bounds);
@@ -524,10 +952,191 @@ public:
     }
 
 private:
+    /// Joins the items listed under two entries whose cells are within `dist` of each other (see join).
+    /// Items are listed in every cell they overlap, so a pair of items may be listed together in many pairs of cells.
+    /// Each pair is only reported by the cells containing a unique pair of points: the minimum corner `p` of the part
+    /// of `b` within `dist` of `a`, and the point of `a` closest to `p`.
+    template <typename F>
+    static void join_entries(const typename Node::Entry &a, const Box<N> &cell_a, const typename Node::Entry &b,
+                             const Box<N> &cell_b, const I64 dist, F &f) {
+        if (a.kind == Node::Entry::kNode) {
+            for (const auto &[key, entry] : a.node->map) {
+                const Pos<N> pos = a.node->pos(key);
+                const Box<N> cell(pos, pos + a.node->grid - 1);
+                if (cell.widened(dist).overlaps(cell_b)) {
+                    join_entries(entry, cell, b, cell_b, dist, f);
+                }
+            }
+        } else if (b.kind == Node::Entry::kNode) {
+            for (const auto &[key, entry] : b.node->map) {
+                const Pos<N> pos = b.node->pos(key);
+                const Box<N> cell(pos, pos + b.node->grid - 1);
+                if (cell.widened(dist).overlaps(cell_a)) {
+                    join_entries(a, cell_a, entry, cell, dist, f);
+                }
+            }
+        } else {
+            for (const ItemRef &x : a.list) {
+                const Box<N> box_x = bbox(x);
+                const Box<N> reach = box_x.widened(dist);
+                for (const ItemRef &y : b.list) {
+                    const Maybe<Box<N>> near = reach.intersect(bbox(y));
+                    if (near.has_value() && cell_b.contains(near->min)) {
+                        Pos<N> closest;
+                        for (U64 d = 0; d < N; ++d) {
+                            closest[d] = std::clamp(near->min[d], box_x.min[d], box_x.max[d]);
+                        }
+                        if (cell_a.contains(closest)) {
+                            f(x, y);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /// Returns the summary of a single item.
+    pure static Aggregate aggregate(const ItemRef &item) {
+        return {.count = 1, .value = Summary::of(*static_cast<const Item *>(item.ptr()))};
+    }
+
+    /// Returns the summary of the items owned by the entry at `pos` in `node`.
+    pure static Aggregate summarize(const Node *node, const Pos<N> &pos, const typename Node::Entry &entry) {
+        return_if(entry.kind == Node::Entry::kNode, entry.node->summary);
+        const Box<N> cell(pos, pos + node->grid - 1);
+        Aggregate result;
+        for (const ItemRef &item : entry.list) {
+            if (cell.contains(bbox(item).min)) {
+                result.add(aggregate(item));
+            }
+        }
+        return result;
+    }
+
+    /// Recomputes the summary of the entry at `pos` in `node`, if it still exists, and of each node above it.
+    void refresh(Node *node, Pos<N> pos) {
+        if constexpr (kSummarized) {
+            while (true) {
+                if (auto *entry = node->get(pos)) {
+                    entry->summary = summarize(node, pos, *entry);
+                }
+                return_if(!node->parent.has_value()); // The summary of the root as a whole is never needed
+                node->summary = {};
+                for (const auto &[_, entry] : node->map) {
+                    node->summary.add(entry.summary);
+                }
+                pos = node->parent->box.min;
+                node = node->parent->node;
+            }
+        }
+    }
+
+    /// Refreshes the summary of the leaf entry containing `pt`, e.g. after the item owned there moved.
+    void refresh_at(const Pos<N> &pt) {
+        if constexpr (kSummarized) {
+            for (auto [node, pos] : entries_in(Box<N>::unit(pt))) {
+                refresh(node, pos);
+            }
+        }
+    }
+
+    /// Returns true if every item overlapping `box` which is anchored in `cell` is owned by one of the cell's entries.
+    /// An item is anchored in the cell containing the minimum corner of its intersection with the box, which is its own
+    /// minimum corner unless it extends past the minimum of the box.
+    pure static bool owns_anchored(const Box<N> &cell, const Box<N> &box) {
+        for (U64 d = 0; d < N; ++d) {
+            return_if(cell.min[d] <= box.min[d], false);
+        }
+        return true;
+    }
+
+    pure static bool contains(const Box<N> &outer, const Box<N> &inner) {
+        return outer.contains(inner.min) && outer.contains(inner.max);
+    }
+
+    /// Returns the combined summary of the items overlapping `box`, counting each in the one cell it is anchored in.
+    pure Aggregate summarize(const Box<N> &box) const {
+        Aggregate result;
+        if (loose()) {
+            queries_ += count_queries_;
+            for (const auto &[grid, cells] : loose_) {
+                loose_cells(grid, cells, box, [&](const Pos<N> &key, const LooseCell &cell) {
+                    cells_visited_ += count_queries_;
+                    if (contains(box, loose_extent(grid, key))) {
+                        result.add(cell.summary);
+                        return;
+                    }
+                    for (const ItemRef &item : cell.list) {
+                        if (bbox(item).overlaps(box)) {
+                            result.add(aggregate(item));
+                        }
+                    }
+                });
+            }
+            return result;
+        }
+        for (const Pos<N> &pos : root_->pos_iter(box)) {
+            if (const auto *entry = root_->get(pos)) {
+                result.add(summarize(*entry, Box<N>(pos, pos + grid_max - 1), box));
+            }
+        }
+        return result;
+    }
+
+    pure static Aggregate summarize(const typename Node::Entry &entry, const Box<N> &cell, const Box<N> &box) {
+        if (owns_anchored(cell, box)) {
+            return_if(entry.summary.count == 0, Aggregate());
+            return_if(contains(box, cell), entry.summary);
+        }
+        Aggregate result;
+        if (entry.kind == Node::Entry::kNode) {
+            const Node *node = entry.node;
+            for (const auto &[key, child] : node->map) {
+                const Pos<N> pos = node->pos(key);
+                const Box<N> child_cell(pos, pos + node->grid - 1);
+                if (child_cell.overlaps(box)) {
+                    result.add(summarize(child, child_cell, box));
+                }
+            }
+        } else {
+            for (const ItemRef &item : entry.list) {
+                const Maybe<Box<N>> overlap = bbox(item).intersect(box);
+                if (overlap.has_value() && cell.contains(overlap->min)) {
+                    result.add(aggregate(item));
+                }
+            }
+        }
+        return result;
+    }
+
+    template <typename Pred>
+    pure static bool any_in(const typename Node::Entry &entry, const Box<N> &cell, const Box<N> &box, Pred &pred) {
+        if (owns_anchored(cell, box)) {
+            return_if(entry.summary.count == 0 || !pred(entry.summary.value), false);
+            return_if(contains(box, cell), true);
+        }
+        if (entry.kind == Node::Entry::kNode) {
+            const Node *node = entry.node;
+            for (const auto &[key, child] : node->map) {
+                const Pos<N> pos = node->pos(key);
+                const Box<N> child_cell(pos, pos + node->grid - 1);
+                return_if(child_cell.overlaps(box) && any_in(child, child_cell, box, pred), true);
+            }
+            return false;
+        }
+        return entry.list.range().exists([&](const ItemRef &item) {
+            return bbox(item).overlaps(box) && pred(aggregate(item).value);
+        });
+    }
+
+    /// Returns the level of nodes with the given grid size, where the root is level 0.
+    pure static U64 level(const I64 grid) { return ceil_log2(grid_max) - ceil_log2(grid); }
+
     Node *next_node(const Maybe<typename Node::Parent> &parent, const I64 grid, const List<ItemRef> &items) {
         const Pos<N> grid_fill = Pos<N>::fill(grid);
         const U64 id = node_id_++;
         Node *node = &nodes_.emplace(std::piecewise_construct, std::forward_as_tuple(id), std::tuple{});
+        level_nodes_[level(grid)] += 1;
         node->parent = parent;
         node->id = id;
         node->grid = grid;
@@ -543,13 +1152,19 @@ private:
             }
             for (const Box<N> &range : points) {
                 if (range.overlaps(item_box)) {
-                    typename Node::Entry &entry = node->map.get_or_add(range.min, {});
+                    typename Node::Entry &entry = node->map.get_or_add(node->key(range.min), {});
                     entry.list.push_back(item);
                 }
             }
         }
         // Re-balance the newly created node. This may create more nodes!
         balance(node);
+        if constexpr (kSummarized) {
+            for (auto &[key, entry] : node->map) {
+                entry.summary = summarize(node, node->pos(key), entry);
+                node->summary.add(entry.summary);
+            }
+        }
         return node;
     }
 
@@ -572,8 +1187,8 @@ private:
 
     void balance(Node *node) {
         return_if(node->grid <= grid_min); // Can't further balance
-        for (auto &[pos, _] : node->map) {
-            balance_pos(node, pos);
+        for (auto &[key, _] : node->map) {
+            balance_pos(node, node->pos(key));
         }
     }
 
@@ -588,10 +1203,12 @@ private:
                 Node *child = entry->node;
                 garbage_.push_back(child->id);
             }
-            node->map.remove(pos);
+            node->map.remove(node->key(pos));
         }
         if (node->map.empty() && node->parent.has_value()) {
             remove(node->parent->node, node->parent->box.min);
+        } else {
+            refresh(node, pos);
         }
     }
 
@@ -601,6 +1218,8 @@ private:
             entry->list.remove(item); // TODO: O(N) with number of items here
             if (entry->list.empty()) {
                 remove(node, pos);
+            } else {
+                refresh(node, pos);
             }
         }
     }
@@ -616,20 +1235,39 @@ private:
         bbox_ = bbox_ ? bounding_box(*bbox_, new_box) : new_box;
         if (auto pair = get_item(item)) {
             auto [_, ref] = *pair;
+            if (loose()) {
+                loose_erase(item, prev_box);
+                loose_insert(item, new_box);
+                return *this;
+            }
+            // Cells which overlap both the removed and retained volumes must keep the item, and cells which overlap
+            // both the added and previous volumes already have it.
             for (const auto &removed : prev_box.diff(new_box)) {
-                remove_over(item, removed, false);
+                remove_over(item, removed, false, &new_box);
             }
             for (const auto &added : new_box.diff(prev_box)) {
-                populate_over(item, added);
+                populate_over(item, added, &prev_box);
             }
+            // The item may now be owned by another cell, and its summary may have changed
+            refresh_at(prev_box.min);
+            refresh_at(new_box.min);
         }
         return *this;
     }
 
-    void populate_over(const ItemRef &ref, const Box<N> &box) {
+    /// Adds the item to all cells overlapping `box`, skipping cells which overlap `skip`, if given.
+    /// In the loose layout, `box` must be the whole volume of the item.
+    void populate_over(const ItemRef &ref, const Box<N> &box, const Box<N> *skip = nullptr) {
+        if (loose()) {
+            loose_insert(ref, box);
+            return;
+        }
         for (auto [node, pos] : points_in(box)) {
-            node->map[pos].list.emplace_back(ref);
-            balance(node, pos);
+            if (skip == nullptr || !Box<N>(pos, pos + node->grid - 1).overlaps(*skip)) {
+                node->map[node->key(pos)].list.emplace_back(ref);
+                balance(node, pos);
+                refresh(node, pos);
+            }
         }
     }
 
@@ -657,23 +1295,34 @@ private:
     ItemRef emplace_over(Args &&...args) {
         const U64 id = ++item_id_;
         auto &unique = items_[id] = std::move(std::make_unique<T>(std::forward<Args>(args)...));
-        bbox_ = bbox_ ? bounding_box(*bbox_, unique->bbox()) : unique->bbox();
+        const Box<N> box = unique->bbox();
+        bbox_ = bbox_ ? bounding_box(*bbox_, box) : box;
         ItemRef ref(unique.get());
         item_ids_[ref] = id;
-        populate_over(ref, unique->bbox());
+        populate_over(ref, box);
         return ref;
     }
 
-    RTree &remove_over(const ItemRef item, const Box<N> &box, const bool remove_all) {
+    /// Removes the item from all cells overlapping `box`, skipping cells which overlap `skip`, if given.
+    RTree &remove_over(const ItemRef item, const Box<N> &box, const bool remove_all, const Box<N> *skip = nullptr) {
         if (auto pair = get_item(item)) {
             // TODO: Update bounds?
+            if (loose()) {
+                loose_erase(item, box);
+            }
             for (auto [node, pos] : entries_in(box)) {
-                remove(node, pos, pair->second);
+                if (skip == nullptr || !Box<N>(pos, pos + node->grid - 1).overlaps(*skip)) {
+                    remove(node, pos, pair->second);
+                }
             }
             if (remove_all) {
                 items_.remove(pair->first);
+                item_ids_.remove(item);
             }
             for (const U64 removed_id : garbage_) {
+                if (const Node *node = nodes_.get(removed_id)) {
+                    level_nodes_[level(node->grid)] -= 1;
+                }
                 nodes_.erase(removed_id);
             }
             garbage_.clear();
@@ -681,6 +1330,173 @@ private:
         return *this;
     }
 
+    /// Items listed in a cell of the loose layout, along with their combined summary.
+    struct LooseCell {
+        List<ItemRef> list;
+        Aggregate summary; // Only kept with a summary policy
+    };
+    using LooseCells = Map<Pos<N>, LooseCell>;
+
+    /// Returns the grid size and key of the loose cell listing an item with volume `box`: the cell of the finest grid
+    /// at least as large as the box in every dimension, which contains its minimum corner.
+    pure static std::pair<I64, Pos<N>> loose_cell(const Box<N> &box) {
+        const Pos<N> shape = box.shape();
+        I64 extent = 1;
+        for (U64 d = 0; d < N; ++d) {
+            extent = std::max(extent, shape[d]);
+        }
+        const I64 grid = I64(1) << std::max<U64>(kGridExpMin, ceil_log2(extent - 1));
+        return {grid, box.min.grid_min(grid)};
+    }
+
+    /// Returns the volume which all items listed in the loose cell at `key` of a grid of size `grid` lie within.
+    pure static Box<N> loose_extent(const I64 grid, const Pos<N> &key) { return Box<N>(key, key + 2 * grid - 2); }
+
+    void loose_insert(const ItemRef &ref, const Box<N> &box) {
+        const auto [grid, key] = loose_cell(box);
+        LooseCell &cell = loose_[grid][key];
+        cell.list.push_back(ref);
+        if constexpr (kSummarized) {
+            cell.summary.add(aggregate(ref));
+        }
+    }
+
+    void loose_erase(const ItemRef &ref, const Box<N> &box) {
+        const auto [grid, key] = loose_cell(box);
+        if (LooseCells *cells = loose_.get(grid)) {
+            if (LooseCell *cell = cells->get(key)) {
+                cell->list.remove(ref);
+                if (cell->list.empty()) {
+                    cells->remove(key);
+                } else if constexpr (kSummarized) {
+                    cell->summary = {};
+                    for (const ItemRef &item : cell->list) {
+                        cell->summary.add(aggregate(item));
+                    }
+                }
+            }
+            if (cells->empty()) {
+                loose_.remove(grid);
+            }
+        }
+    }
+
+    /// Calls `f(key)` with the key of each loose cell of a grid of size `grid` whose items may overlap `box`. The keys
+    /// are enumerated directly, or if there are more of them than existing cells, only those of the existing cells.
+    template <typename F>
+    static void loose_keys(const I64 grid, const LooseCells &cells, const Box<N> &box, F &&f) {
+        // Only the loose cells of these keys can overlap the box. Walk the map instead if it has fewer cells.
+        const Box<N> keys = Box<N>(box.min - (2 * grid - 2), box.max).clamp(grid);
+        U64 num_keys = 1;
+        for (U64 d = 0; d < N && num_keys <= cells.size(); ++d) {
+            num_keys *= keys.shape()[d] / grid;
+        }
+        if (num_keys <= cells.size()) {
+            for (const Pos<N> &key : keys.pos_iter(grid)) {
+                f(key);
+            }
+        } else {
+            for (const auto &[key, _] : cells) {
+                if (keys.contains(key)) {
+                    f(key);
+                }
+            }
+        }
+    }
+
+    /// Calls `f(key, cell)` for each existing loose cell of a grid of size `grid` whose items may overlap `box`.
+    template <typename F>
+    static void loose_cells(const I64 grid, const LooseCells &cells, const Box<N> &box, F &&f) {
+        loose_keys(grid, cells, box, [&](const Pos<N> &key) {
+            if (const LooseCell *cell = cells.get(key)) {
+                f(key, *cell);
+            }
+        });
+    }
+
+    /// Returns the items overlapping `box` in the loose layout. Loose cells are looked up all at once, since there are
+    /// only a few per grid and no items to deduplicate.
+    pure List<ItemRef> loose_items(const Box<N> &box) const {
+        List<ItemRef> items;
+        loose_query(box, [&](const ItemRef &item) { items.push_back(item); });
+        return items;
+    }
+
+    /// Calls `f(item)` once for each item overlapping `box` in the loose layout.
+    template <typename F>
+    void loose_query(const Box<N> &box, F &&f) const {
+        queries_ += count_queries_;
+        for (const auto &[grid, cells] : loose_) {
+            loose_cells(grid, cells, box, [&](const Pos<N> &, const LooseCell &cell) {
+                cells_visited_ += count_queries_;
+                for (const ItemRef &item : cell.list) {
+                    if (bbox(item).overlaps(box)) {
+                        f(item);
+                    }
+                }
+            });
+        }
+    }
+
+    /// Calls `f(i, item)` once for each item overlapping the i-th volume in the loose layout (see query_many). The
+    /// keys of the loose cells each volume may overlap are gathered and sorted first, so that each cell is looked up
+    /// and visited once for all of its volumes. Each item is listed in only one cell, so items need not be deduplicated.
+    template <typename F>
+    void loose_query_many(const List<Box<N>> &queries, F &&f) const {
+        if (queries.size() == 1) {
+            loose_query(queries.front(), [&](const ItemRef &item) { f(0, item); });
+            return;
+        }
+        queries_ += count_queries_ * queries.size();
+        struct Visit {
+            Pos<N> key;
+            U64 query;
+        };
+        std::vector<Visit> visits;
+        BoxArray<N> item_boxes; // Boxes of the items in the current cell, when it is shared by several volumes
+        for (const auto &[grid, cells] : loose_) {
+            visits.clear();
+            for (U64 i = 0; i < queries.size(); ++i) {
+                loose_keys(grid, cells, queries[i], [&](const Pos<N> &key) { visits.push_back({key, i}); });
+            }
+            // Sort the visits by key, keeping the volumes of each cell in order
+            std::sort(visits.begin(), visits.end(), [](const Visit &a, const Visit &b) {
+                for (U64 d = 0; d < N; ++d) {
+                    return_if(a.key[d] != b.key[d], a.key[d] < b.key[d]);
+                }
+                return a.query < b.query;
+            });
+            for (U64 begin = 0, end = 0; begin < visits.size(); begin = end) {
+                while (end < visits.size() && visits[end].key == visits[begin].key) {
+                    ++end;
+                }
+                const LooseCell *cell = cells.get(visits[begin].key);
+                if (cell == nullptr) {
+                    continue;
+                }
+                cells_visited_ += count_queries_;
+                if (end - begin == 1) {
+                    const U64 i = visits[begin].query;
+                    for (const ItemRef &item : cell->list) {
+                        if (bbox(item).overlaps(queries[i])) {
+                            f(i, item);
+                        }
+                    }
+                    continue;
+                }
+                // Gather the item boxes once, then test them against each volume together
+                item_boxes.clear();
+                for (const ItemRef &item : cell->list) {
+                    item_boxes.push_back(bbox(item));
+                }
+                for (U64 k = begin; k < end; ++k) {
+                    const U64 i = visits[k].query;
+                    item_boxes.overlapping(queries[i], [&](const U64 j) { f(i, cell->list[j]); });
+                }
+            }
+        }
+    }
+
     Maybe<Box<N>> bbox_ = None;
     U64 node_id_ = 0;
     U64 item_id_ = 0;
@@ -691,11 +1507,24 @@ private:
     Map<U64, std::unique_ptr<Item>> items_;
     Map<ItemRef, U64, ItemRefHash> item_ids_;
 
+    // Number of nodes at each level, used to track depth incrementally. Declared before root_ so that it is
+    // initialized before the root node is created.
+    std::array<U64, kLevels> level_nodes_{};
+
     Map<U64, Node> nodes_;
     Node *root_;
 
+    // Optional query counters (see count_queries)
+    bool count_queries_ = false;
+    mutable U64 queries_ = 0;
+    mutable U64 cells_visited_ = 0;
+
     // List of nodes to be removed
     List<U64> garbage_;
+
+    // Items in the loose layout, by grid size and then by the key of their loose cell
+    Layout layout_ = Layout::kGrid;
+    Map<I64, LooseCells> loose_;
 };
 
 } // namespace nvl
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Range.h"
+#include "nvl/geo/Box.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @concept SpatialIndex
+ * @brief Index which owns items with volumes and finds the items overlapping a given volume, e.g. RTree or HashGrid.
+ *
+ * Items are referred to by `ItemRef`s, which remain valid until the item is removed. An item's volume may only change
+ * if the index is told with `move`, or is rebuilt afterward.
+ */
+template <typename Index, U64 N, typename Item, typename ItemRef>
+concept SpatialIndex = requires(Index index, const Index &const_index, const Item &item, const ItemRef &ref,
+                                std::unique_ptr<Item> owned, std::vector<std::unique_ptr<Item>> all,
+                                const Box<N> &box, const Range<Box<N>> &boxes) {
+    { index.insert(item) } -> std::same_as<ItemRef>;
+    { index.take(std::move(owned)) } -> std::same_as<ItemRef>;
+    { index.take(std::move(all)) } -> std::same_as<List<ItemRef>>;
+    { index.template emplace<Item>(item) } -> std::same_as<ItemRef>;
+    index.remove(ref);
+    { index.release(ref) } -> std::same_as<std::unique_ptr<Item>>;
+    index.move(ref, box);
+    index.rebuild();
+    { const_index[box] } -> std::same_as<Range<ItemRef>>;
+    const_index.query_many(boxes, [](U64, const ItemRef &) {});
+    { const_index.items() } -> std::same_as<Range<ItemRef>>;
+    { const_index.has(ref) } -> std::same_as<bool>;
+    { const_index.size() } -> std::same_as<U64>;
+};
+
+/**
+ * @class AnyIndex
+ * @brief Spatial index which is one of several backends, chosen when it is constructed.
+ *
+ * Calls are dispatched to the backend with std::visit, so no backend needs a common base class or virtual methods.
+ * This allows e.g. a World to choose the index which best suits its contents without changing its type.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ * @tparam Item Value type being stored.
+ * @tparam ItemRef Reference to a stored item.
+ * @tparam Backends Types of spatial index which may be used.
+ */
+template <U64 N, typename Item, typename ItemRef, typename... Backends>
+    requires(SpatialIndex<Backends, N, Item, ItemRef> && ...)
+class AnyIndex {
+public:
+    /// Constructs an index with a default constructed instance of the first backend.
+    AnyIndex() = default;
+
+    /// Constructs an index with a backend of type `Backend`, constructed from `args`.
+    template <typename Backend, typename... Args>
+    explicit AnyIndex(std::in_place_type_t<Backend> type, Args &&...args)
+        : backend_(type, std::forward<Args>(args)...) {}
+
+    /// Replaces the backend with a new one of type `Backend`, constructed from `args`. All items are discarded.
+    template <typename Backend, typename... Args>
+    Backend &reset(Args &&...args) {
+        return backend_.template emplace<Backend>(std::forward<Args>(args)...);
+    }
+
+    ItemRef insert(const Item &item) {
+        return std::visit([&](auto &index) { return index.insert(item); }, backend_);
+    }
+
+    ItemRef take(std::unique_ptr<Item> item) {
+        return std::visit([&](auto &index) { return index.take(std::move(item)); }, backend_);
+    }
+
+    List<ItemRef> take(std::vector<std::unique_ptr<Item>> items) {
+        return std::visit([&](auto &index) { return index.take(std::move(items)); }, backend_);
+    }
+
+    template <typename T = Item, typename... Args>
+    ItemRef emplace(Args &&...args) {
+        return std::visit([&](auto &index) { return index.template emplace<T>(std::forward<Args>(args)...); },
+                          backend_);
+    }
+
+    AnyIndex &remove(const ItemRef &item) {
+        std::visit([&](auto &index) { index.remove(item); }, backend_);
+        return *this;
+    }
+
+    std::unique_ptr<Item> release(const ItemRef &item) {
+        return std::visit([&](auto &index) { return index.release(item); }, backend_);
+    }
+
+    AnyIndex &move(const ItemRef &item, const Box<N> &prev) {
+        std::visit([&](auto &index) { index.move(item, prev); }, backend_);
+        return *this;
+    }
+
+    void rebuild() {
+        std::visit([](auto &index) { index.rebuild(); }, backend_);
+    }
+
+    pure MRange<ItemRef> operator[](const Box<N> &box) {
+        return std::visit([&](auto &index) -> MRange<ItemRef> { return index[box]; }, backend_);
+    }
+    pure Range<ItemRef> operator[](const Box<N> &box) const {
+        return std::visit([&](const auto &index) -> Range<ItemRef> { return index[box]; }, backend_);
+    }
+
+    template <typename F>
+    void query_many(const Range<Box<N>> &boxes, F &&f) const {
+        std::visit([&](const auto &index) { index.query_many(boxes, f); }, backend_);
+    }
+
+    pure Range<ItemRef> items() const {
+        return std::visit([](const auto &index) -> Range<ItemRef> { return index.items(); }, backend_);
+    }
+
+    pure bool has(const ItemRef &item) const {
+        return std::visit([&](const auto &index) { return index.has(item); }, backend_);
+    }
+
+    pure U64 size() const {
+        return std::visit([](const auto &index) { return index.size(); }, backend_);
+    }
+
+    pure bool empty() const { return size() == 0; }
+
+    /// Returns the backend, if it is of type `Backend`.
+    template <typename Backend>
+    pure const Backend *get() const {
+        return std::get_if<Backend>(&backend_);
+    }
+
+private:
+    std::variant<Backends...> backend_;
+};
+
+} // namespace nvl
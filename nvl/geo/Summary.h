@@ -0,0 +1,70 @@
+#pragma once
+
+#include "nvl/data/Maybe.h"
+#include "nvl/geo/Box.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @struct NoSummary
+ * @brief Summary policy for RTree which keeps no summaries.
+ *
+ * A summary policy is a monoid over values which summarize items:
+ *   using Value = ...;
+ *   static Value identity();                           // Summary of no items
+ *   static Value of(const Item &item);                 // Summary of a single item
+ *   static Value combine(const Value &, const Value &); // Associative and commutative
+ */
+struct NoSummary {
+    struct Value {};
+    pure static Value identity() { return {}; }
+    template <typename Item>
+    pure static Value of(const Item &) {
+        return {};
+    }
+    pure static Value combine(const Value &, const Value &) { return {}; }
+};
+
+/**
+ * @struct CountSummary
+ * @brief Summary policy which only keeps the number of items in each cell (see RTree::count_in).
+ */
+struct CountSummary : NoSummary {};
+
+/**
+ * @struct FlagSummary
+ * @brief Summary policy which keeps the union of the flags of items, as given by `Flags()(item)`.
+ */
+template <typename Flags>
+struct FlagSummary {
+    using Value = U64;
+    pure static Value identity() { return 0; }
+    template <typename Item>
+    pure static Value of(const Item &item) {
+        return Flags()(item);
+    }
+    pure static Value combine(const Value &a, const Value &b) { return a | b; }
+};
+
+/**
+ * @struct BoundsSummary
+ * @brief Summary policy which keeps the bounding box of items, e.g. to find the lowest item in a volume.
+ */
+template <U64 N>
+struct BoundsSummary {
+    using Value = Maybe<Box<N>>;
+    pure static Value identity() { return None; }
+    template <typename Item>
+    pure static Value of(const Item &item) {
+        return item.bbox();
+    }
+    pure static Value combine(const Value &a, const Value &b) {
+        return_if(!a.has_value(), b);
+        return_if(!b.has_value(), a);
+        return bounding_box(*a, *b);
+    }
+};
+
+} // namespace nvl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <span>
+#include <string>
+
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of an entire file, unmapped on destruction.
+ */
+class MappedFile {
+public:
+    /// Maps the file at `path`. Check valid() to see if the file could be opened and mapped.
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    pure bool valid() const { return data_ != nullptr; }
+    pure const char *data() const { return data_; }
+    pure U64 size() const { return size_; }
+    pure std::span<const char> bytes() const { return {data_, size_}; }
+
+private:
+    const char *data_ = nullptr;
+    U64 size_ = 0;
+};
+
+} // namespace nvl
@@ -6,7 +6,10 @@ namespace nvl {
 
 #define F64 double
 #define I64 int64_t
+#define I32 int32_t
 #define U64 size_t
+#define U32 uint32_t
+#define U16 uint16_t
 #define U8 uint8_t
 
 } // namespace nvl
@@ -10,4 +10,11 @@ namespace nvl {
         std::exit(-1);                                                                                                 \
     }
 
+/// Asserts only in debug builds, for checks which are too costly to make in hot paths of release builds.
+#ifdef NDEBUG
+#define DEBUG_ASSERT(condition, message) static_cast<void>(0)
+#else
+#define DEBUG_ASSERT(condition, message) ASSERT(condition, message)
+#endif
+
 } // namespace nvl
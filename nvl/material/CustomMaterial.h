@@ -0,0 +1,16 @@
+#pragma once
+
+#include "nvl/material/Material.h"
+#include "nvl/reflect/ClassTag.h"
+#include "nvl/ui/Color.h"
+
+namespace nvl {
+
+/// Material with arbitrary properties, e.g. for materials loaded from a snapshot which have no registered equivalent.
+struct CustomMaterial final : AbstractMaterial {
+    class_tag(CustomMaterial, AbstractMaterial);
+    explicit CustomMaterial(const Color color, const I64 durability, const bool falls, const bool outline = true)
+        : AbstractMaterial(color, durability, falls, outline) {}
+};
+
+} // namespace nvl
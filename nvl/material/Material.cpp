@@ -0,0 +1,10 @@
+#include "nvl/material/Material.h"
+
+namespace nvl {
+
+MaterialTable &MaterialTable::global() {
+    static MaterialTable table;
+    return table;
+}
+
+} // namespace nvl
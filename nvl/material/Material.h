@@ -1,23 +1,34 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/data/Maybe.h"
+#include "nvl/data/SipHash.h"
 #include "nvl/macros/Abstract.h"
 #include "nvl/macros/Aliases.h"
-#include "nvl/reflect/Castable.h"
+#include "nvl/macros/Expand.h"
+#include "nvl/macros/Implicit.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+#include "nvl/reflect/Casting.h"
 #include "nvl/reflect/ClassTag.h"
 #include "nvl/ui/Color.h"
 
 namespace nvl {
 
-struct Material;
-
-abstract struct AbstractMaterial : Castable<Material, AbstractMaterial>::BaseClass {
+abstract struct AbstractMaterial {
     class_tag(AbstractMaterial);
 
-    explicit AbstractMaterial(const Color color, const I64 durability, const bool falls = true)
-        : color(color), durability(durability), falls(falls) {}
+    explicit AbstractMaterial(const Color color, const I64 durability, const bool falls = true,
+                              const bool outline = true)
+        : color(color), durability(durability), falls(falls), outline(outline) {}
+    virtual ~AbstractMaterial() = default;
 
     Color color;
     I64 durability;
@@ -25,9 +36,170 @@ abstract struct AbstractMaterial : Castable<Material, AbstractMaterial>::BaseCla
     bool outline = true;
 };
 
-struct Material final : Castable<Material, AbstractMaterial, std::shared_ptr<AbstractMaterial>> {
-    using Castable::Castable;
-    using Castable::get;
+/**
+ * @class MaterialTable
+ * @brief Global registry which owns every material and hands out compact ids for them.
+ *
+ * Materials are flyweights: parts and entities only hold the id, and all properties are resolved through this table.
+ * Materials are interned, so adding a material with the same type and properties as an existing one returns the id of
+ * the existing material. Since ids are shared, materials are immutable once added; a material with different
+ * properties is added with `modified` instead. Id 0 is reserved for the "null" material.
+ */
+class MaterialTable {
+public:
+    using Id = U32;
+
+    /// Type and properties which identify an interned material.
+    struct Key {
+        static Key of(const AbstractMaterial &material) {
+            return {.type = material._get_classtag().name,
+                    .color = material.color,
+                    .durability = material.durability,
+                    .falls = material.falls,
+                    .outline = material.outline};
+        }
+
+        pure bool operator==(const Key &rhs) const = default;
+
+        struct Hash {
+            pure U64 operator()(const Key &key) const noexcept {
+                const std::array<U64, 7> values = {std::hash<std::string_view>()(key.type),
+                                                   key.color.r,
+                                                   key.color.g,
+                                                   key.color.b,
+                                                   key.color.a,
+                                                   static_cast<U64>(key.durability),
+                                                   U64(key.falls) << 1 | U64(key.outline)};
+                return sip_hash(values);
+            }
+        };
+
+        std::string_view type; // Class name of the material
+        Color color;
+        I64 durability;
+        bool falls;
+        bool outline;
+    };
+
+    /// Returns the process-wide material table.
+    static MaterialTable &global();
+
+    /// Constructs a material of type T and returns its id, or returns the id of an identical existing material.
+    template <typename T, typename... Args>
+    Id add(Args &&...args) {
+        return intern(std::make_unique<T>(std::forward<Args>(args)...), &copy<T>);
+    }
+
+    /// Returns the id of a material of the same type as `id`, with the properties changed by `modify`.
+    /// The material `id` itself is not changed, since other parts may share it.
+    template <typename Modify>
+    Id modified(const Id id, Modify &&modify) {
+        const Copy copy = copies_[id];
+        std::unique_ptr<AbstractMaterial> material = copy(*get(id));
+        modify(*material);
+        return intern(std::move(material), copy);
+    }
+
+    /// Returns the id of the material with the given type and properties, if one has been added.
+    pure Maybe<Id> find(const Key &key) const {
+        const Id *id = index_.get(key);
+        return_if(id == nullptr, None);
+        return *id;
+    }
+
+    pure expand const AbstractMaterial *get(const Id id) const { return materials_[id].get(); }
+
+    /// Returns the number of registered materials, including the null material.
+    pure U64 size() const { return materials_.size(); }
+
+private:
+    using Copy = std::unique_ptr<AbstractMaterial> (*)(const AbstractMaterial &);
+
+    template <typename T>
+    static std::unique_ptr<AbstractMaterial> copy(const AbstractMaterial &material) {
+        return std::make_unique<T>(static_cast<const T &>(material));
+    }
+
+    MaterialTable() {
+        materials_.emplace_back(nullptr);
+        copies_.push_back(nullptr);
+    }
+
+    Id intern(std::unique_ptr<AbstractMaterial> material, const Copy copy) {
+        const Key key = Key::of(*material);
+        if (const Maybe<Id> existing = find(key)) {
+            return *existing;
+        }
+        materials_.push_back(std::move(material));
+        copies_.push_back(copy);
+        const Id id = static_cast<Id>(materials_.size() - 1);
+        index_[key] = id;
+        return id;
+    }
+
+    List<std::unique_ptr<AbstractMaterial>> materials_;
+    List<Copy> copies_; // Copies a material with its concrete type, by id
+    Map<Key, Id, Key::Hash> index_;
+};
+
+/**
+ * @struct Material
+ * @brief Compact handle to a material registered in the global MaterialTable.
+ *
+ * Copying a Material copies only its id - there is no reference counting involved. The material itself is shared by
+ * every handle with the same id, so it can only be read through a handle. Use `with` to get a modified material.
+ */
+struct Material final {
+    using Id = MaterialTable::Id;
+
+    /// Returns a handle to the material of type R with the given properties, registering it if it does not exist yet.
+    template <typename R, typename... Args>
+    static Material get(Args &&...args) {
+        return Material(MaterialTable::global().add<R>(std::forward<Args>(args)...));
+    }
+
+    Material() = default;
+    explicit Material(const Id id) : id_(id) {}
+    implicit Material(nullptr_t) {}
+
+    explicit operator bool() const { return id_ != 0; }
+
+    pure bool operator==(const Material &rhs) const { return id_ == rhs.id_; }
+    pure bool operator!=(const Material &rhs) const { return id_ != rhs.id_; }
+    pure bool operator==(nullptr_t) const { return id_ == 0; }
+    pure bool operator!=(nullptr_t) const { return id_ != 0; }
+
+    const AbstractMaterial &operator*() const { return *ptr(); }
+    const AbstractMaterial *operator->() const { return ptr(); }
+
+    template <typename B>
+    pure expand const B *dyn_cast() const {
+        return nvl::dyn_cast<B>(ptr());
+    }
+
+    template <typename B>
+    pure expand bool isa() const {
+        return nvl::isa<B>(ptr());
+    }
+
+    pure expand const AbstractMaterial *ptr() const { return MaterialTable::global().get(id_); }
+
+    /// Returns a handle to a material of the same type as this one, with the properties changed by `modify`.
+    /// For example, `material.with([](AbstractMaterial &m) { m.outline = false; })`.
+    template <typename Modify>
+    pure Material with(Modify &&modify) const {
+        return Material(MaterialTable::global().modified(id_, std::forward<Modify>(modify)));
+    }
+
+    pure Id id() const { return id_; }
+
+private:
+    Id id_ = 0;
 };
 
 } // namespace nvl
+
+template <>
+struct std::hash<nvl::Material> {
+    pure U64 operator()(const nvl::Material &material) const noexcept { return material.id(); }
+};
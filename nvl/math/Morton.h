@@ -0,0 +1,222 @@
+#pragma once
+
+#include <bit>
+
+#include "nvl/data/Iterator.h"
+#include "nvl/data/Maybe.h"
+#include "nvl/data/Range.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Assert.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+/**
+ * @struct Morton
+ * @brief Morton (Z-order) codes of cells in an N-dimensional grid with a power of two cell size.
+ *
+ * A code interleaves the bits of the cell's indices, with bit `b` of dimension `d` at bit `b * N + d` of the code, so
+ * it is computed with shifts and masks alone, and cells which are close in space tend to have close codes. Each index
+ * has 64 / N bits and is stored offset by half its range, so that codes of negative cells sort before positive ones.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ */
+template <U64 N>
+struct Morton {
+    static constexpr U64 kBits = 64 / N; // Bits per dimension
+    static constexpr U64 kMask = kBits == 64 ? ~U64(0) : (U64(1) << kBits) - 1;
+    static constexpr U64 kHalf = U64(1) << (kBits - 1);
+    static constexpr I64 kMax = static_cast<I64>(kHalf - 1); // Largest cell index which can be encoded
+    static constexpr I64 kMin = -kMax - 1;                   // Smallest cell index which can be encoded
+
+    /// Returns true if the cell with the given indices can be encoded.
+    pure static bool fits(const Pos<N> &cell) {
+        for (U64 d = 0; d < N; ++d) {
+            return_if(cell[d] < kMin || cell[d] > kMax, false);
+        }
+        return true;
+    }
+
+    /// Returns the code of the cell with the given indices.
+    pure static U64 encode(const Pos<N> &cell) {
+        ASSERT(fits(cell), "Cell " << cell << " is out of range of " << N << "-dimensional Morton codes");
+        U64 code = 0;
+        for (U64 d = 0; d < N; ++d) {
+            code |= spread((static_cast<U64>(cell[d]) & kMask) ^ kHalf) << d;
+        }
+        return code;
+    }
+
+    /// Returns the code of the cell of size `grid` (a power of two) containing `pos`.
+    pure static U64 encode(const Pos<N> &pos, const I64 grid) {
+        const int exp = std::countr_zero(static_cast<U64>(grid));
+        Pos<N> cell;
+        for (U64 d = 0; d < N; ++d) {
+            cell[d] = pos[d] >> exp; // Arithmetic shift, so negative positions round down like grid_min
+        }
+        return encode(cell);
+    }
+
+    /// Returns the indices of the cell with the given code.
+    pure static Pos<N> decode(const U64 code) {
+        Pos<N> cell;
+        for (U64 d = 0; d < N; ++d) {
+            // Sign extend the index from kBits to 64 bits
+            const U64 index = compact(code >> d) ^ kHalf;
+            cell[d] = static_cast<I64>(index << (64 - kBits)) >> (64 - kBits);
+        }
+        return cell;
+    }
+
+    /// Returns the smallest code greater than `code` of a cell within the box of cells with codes `min` and `max`,
+    /// given that `code` is between `min` and `max` but its cell is outside the box (the BIGMIN of Tropf and Herzog).
+    pure static U64 next_in(const U64 code, U64 min, U64 max) {
+        U64 result = max;
+        for (U64 i = kBits * N; i > 0; --i) {
+            const U64 bit = U64(1) << (i - 1);
+            const U64 below = dim_mask((i - 1) % N) & (bit - 1); // Lower bits of the same dimension
+            const bool c = code & bit, lo = min & bit, hi = max & bit;
+            if (!c && !lo && hi) {
+                result = (min | bit) & ~below;
+                max = (max & ~bit) | below;
+            } else if (!c && lo && hi) {
+                return min;
+            } else if (c && !lo && !hi) {
+                return result;
+            } else if (c && !lo && hi) {
+                min = (min | bit) & ~below;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @struct cell_iterator
+     * @brief Iterates over the cells in a box in Morton order, skipping runs of codes outside of the box.
+     */
+    struct cell_iterator final : AbstractIteratorCRTP<cell_iterator, Pos<N>> {
+        class_tag(Morton<N>::cell_iterator, AbstractIterator<Pos<N>>);
+
+        template <View Type = View::kImmutable>
+            requires(Type == View::kImmutable)
+        static Iterator<Pos<N>, Type> begin(const Box<N> &cells, const I64 grid) {
+            return make_iterator<cell_iterator>(cells, grid, encode(cells.min));
+        }
+        template <View Type = View::kImmutable>
+            requires(Type == View::kImmutable)
+        static Iterator<Pos<N>, Type> end(const Box<N> &cells, const I64 grid) {
+            return make_iterator<cell_iterator>(cells, grid, None);
+        }
+
+        explicit cell_iterator(const Box<N> &cells, const I64 grid, const Maybe<U64> &code)
+            : cells_(cells), grid_(grid), min_(encode(cells.min)), max_(encode(cells.max)), code_(code) {
+            if (code_.has_value()) {
+                pos_ = decode(*code_) * grid_;
+            }
+        }
+
+        const Pos<N> *ptr() override { return &pos_; }
+
+        pure bool operator==(const cell_iterator &rhs) const override {
+            return code_ == rhs.code_ && min_ == rhs.min_ && max_ == rhs.max_;
+        }
+
+        void increment() override {
+            return_if(!code_.has_value());
+            if (*code_ == max_) {
+                code_ = None; // Reached end
+                return;
+            }
+            U64 code = *code_ + 1;
+            Pos<N> cell = decode(code);
+            if (!cells_.contains(cell)) {
+                code = next_in(code, min_, max_);
+                cell = decode(code);
+            }
+            code_ = code;
+            pos_ = cell * grid_;
+        }
+
+    private:
+        Box<N> cells_;
+        I64 grid_;
+        U64 min_;
+        U64 max_;
+        Maybe<U64> code_;
+        Pos<N> pos_;
+    };
+
+    /// Returns the minimum corners of the cells of size `grid` (a power of two) overlapping `box`, in Morton order.
+    pure static Range<Pos<N>> cells_in(const Box<N> &box, const I64 grid) {
+        const int exp = std::countr_zero(static_cast<U64>(grid));
+        Pos<N> min, max;
+        for (U64 d = 0; d < N; ++d) {
+            min[d] = box.min[d] >> exp;
+            max[d] = box.max[d] >> exp;
+        }
+        return make_range<cell_iterator>(Box<N>(min, max), grid);
+    }
+
+private:
+    /// Returns the mask of the bits of dimension `d` in a code.
+    pure static U64 dim_mask(const U64 d) { return spread(kMask) << d; }
+
+    /// Spreads the low kBits bits of `v` apart, so that bit `b` is moved to bit `b * N`.
+    pure static U64 spread(U64 v) {
+        if constexpr (N == 1) {
+            return v;
+        } else if constexpr (N == 2) {
+            v &= 0x00000000FFFFFFFF;
+            v = (v | v << 16) & 0x0000FFFF0000FFFF;
+            v = (v | v << 8) & 0x00FF00FF00FF00FF;
+            v = (v | v << 4) & 0x0F0F0F0F0F0F0F0F;
+            v = (v | v << 2) & 0x3333333333333333;
+            return (v | v << 1) & 0x5555555555555555;
+        } else if constexpr (N == 3) {
+            v &= 0x00000000001FFFFF;
+            v = (v | v << 32) & 0x001F00000000FFFF;
+            v = (v | v << 16) & 0x001F0000FF0000FF;
+            v = (v | v << 8) & 0x100F00F00F00F00F;
+            v = (v | v << 4) & 0x10C30C30C30C30C3;
+            return (v | v << 2) & 0x1249249249249249;
+        } else {
+            U64 result = 0;
+            for (U64 b = 0; b < kBits; ++b) {
+                result |= ((v >> b) & 1) << (b * N);
+            }
+            return result;
+        }
+    }
+
+    /// Inverse of spread: gathers every N-th bit of `v`, starting from bit 0, into the low kBits bits.
+    pure static U64 compact(U64 v) {
+        if constexpr (N == 1) {
+            return v;
+        } else if constexpr (N == 2) {
+            v &= 0x5555555555555555;
+            v = (v | v >> 1) & 0x3333333333333333;
+            v = (v | v >> 2) & 0x0F0F0F0F0F0F0F0F;
+            v = (v | v >> 4) & 0x00FF00FF00FF00FF;
+            v = (v | v >> 8) & 0x0000FFFF0000FFFF;
+            return (v | v >> 16) & 0x00000000FFFFFFFF;
+        } else if constexpr (N == 3) {
+            v &= 0x1249249249249249;
+            v = (v | v >> 2) & 0x10C30C30C30C30C3;
+            v = (v | v >> 4) & 0x100F00F00F00F00F;
+            v = (v | v >> 8) & 0x001F0000FF0000FF;
+            v = (v | v >> 16) & 0x001F00000000FFFF;
+            return (v | v >> 32) & 0x00000000001FFFFF;
+        } else {
+            U64 result = 0;
+            for (U64 b = 0; b < kBits; ++b) {
+                result |= ((v >> (b * N)) & 1) << b;
+            }
+            return result;
+        }
+    }
+};
+
+} // namespace nvl
@@ -37,6 +37,9 @@ public:
 
     std::mt19937 &engine() { return engine_; }
 
+    /// Returns the seed this generator was created with, e.g. to reproduce a run.
+    pure U64 seed() const { return seed_; }
+
 private:
     std::random_device os_seed_;
     const U64 seed_;
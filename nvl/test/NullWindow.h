@@ -7,9 +7,9 @@ namespace nvl::test {
 class NullWindow final : public Window {
 public:
     NullWindow() : Window("null", {0, 0}) {}
-    explicit NullWindow(std::string_view title, Pos<2> shape) : Window(title, shape) {}
+    explicit NullWindow(std::string_view title, Pos<2> shape) : Window(title, shape), shape_(shape) {}
     void draw() override {}
-    void tick() override {}
+    void tick() override { tick_children(); }
     void feed() override {}
     void line_rectangle(const Color &, const Box<2> &) override {}
     void fill_rectangle(const Color &, const Box<2> &) override {}
@@ -17,9 +17,12 @@ public:
     void centered_text(const Color &, const Pos<2> &, I64, std::string_view) override {}
     void set_view_offset(const Maybe<Pos<2>> &) override {}
     pure bool should_close() const override { return false; }
-    pure I64 height() const override { return 0; }
-    pure I64 width() const override { return 0; }
+    pure I64 height() const override { return shape_[1]; }
+    pure I64 width() const override { return shape_[0]; }
     pure I64 fps() const override { return 0; }
+
+private:
+    Pos<2> shape_ = Pos<2>::zero;
 };
 
 } // namespace nvl::test
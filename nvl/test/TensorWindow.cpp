@@ -7,16 +7,10 @@ namespace nvl::test {
 TensorWindow::TensorWindow(std::string_view title, Pos<2> shape)
     : Window(title, shape), title_(title), tensor_(shape, Color::kWhite) {}
 
-void TensorWindow::tick() {
-    for (auto &child : children_) {
-        child->tick_all();
-    }
-}
+void TensorWindow::tick() { tick_children(); }
 
 void TensorWindow::feed() {
-    for (auto iter = children_.begin(); iter != children_.end() && !events_.empty(); ++iter) {
-        events_ = (*iter)->feed_all(events_);
-    }
+    dispatch(std::move(events_));
     events_.clear();
 }
 
@@ -24,6 +24,8 @@ public:
     pure Duration operator+(const U64 rhs) const { return Duration(nanos_ + rhs); }
     pure Duration operator-(const U64 rhs) const { return Duration(nanos_ - rhs); }
 
+    pure U64 nanos() const { return nanos_; }
+
     pure std::string to_string() const;
 
     pure std::string raw() const;
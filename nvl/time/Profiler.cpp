@@ -0,0 +1,105 @@
+#include "nvl/time/Profiler.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "nvl/macros/ReturnIf.h"
+
+namespace nvl {
+
+Profiler &Profiler::global() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Id Profiler::get_or_add(const std::string_view name, const Kind kind) {
+    const std::string key(name);
+    if (const Id *id = ids_.get(key)) {
+        return *id;
+    }
+    const Id id = metrics_.size();
+    metrics_.push_back({.name = key, .kind = kind});
+    ids_[key] = id;
+    return id;
+}
+
+void Profiler::end_frame() {
+    const U64 slot = frames_ % kHistory;
+    for (Metric &metric : metrics_) {
+        metric.history[slot] = metric.value;
+        metric.history_calls[slot] = metric.calls;
+        metric.value = 0;
+        metric.calls = 0;
+    }
+    ++frames_;
+}
+
+void Profiler::reset() {
+    for (Metric &metric : metrics_) {
+        metric = {.name = metric.name, .kind = metric.kind};
+    }
+    frames_ = 0;
+}
+
+Profiler::Summary Profiler::summary(const Id id) const {
+    const Metric &metric = metrics_[id];
+    Summary summary;
+    summary.frames = window();
+    return_if(summary.frames == 0, summary);
+
+    std::vector<U64> values;
+    U64 total = 0;
+    for (U64 i = 0; i < summary.frames; ++i) {
+        const U64 value = metric.history[i];
+        values.push_back(value);
+        total += value;
+        summary.calls += metric.history_calls[i];
+        summary.histogram[std::min<U64>(std::bit_width(value), kBuckets - 1)] += 1;
+    }
+    std::sort(values.begin(), values.end());
+    summary.min = values.front();
+    summary.max = values.back();
+    summary.mean = total / summary.frames;
+    summary.p50 = values[(summary.frames - 1) / 2];
+    summary.p99 = values[(summary.frames - 1) * 99 / 100];
+    summary.last = metric.history[(frames_ - 1) % kHistory];
+    return summary;
+}
+
+void Profiler::write_csv(std::ostream &os) const {
+    os << "frame";
+    for (const Metric &metric : metrics_) {
+        os << "," << metric.name;
+    }
+    os << std::endl;
+    for (U64 frame = frames_ - window(); frame < frames_; ++frame) {
+        os << frame;
+        for (const Metric &metric : metrics_) {
+            os << "," << metric.history[frame % kHistory];
+        }
+        os << std::endl;
+    }
+}
+
+void Profiler::write_json(std::ostream &os) const {
+    os << "{\"frames\": " << frames_ << ", \"window\": " << window() << ", \"metrics\": [";
+    for (Id id = 0; id < metrics_.size(); ++id) {
+        const Metric &metric = metrics_[id];
+        const Summary s = summary(id);
+        os << (id > 0 ? ", " : "") << "{\"name\": \"" << metric.name << "\", \"kind\": \""
+           << (metric.kind == Kind::kTimer ? "timer" : "counter") << "\", \"calls\": " << s.calls
+           << ", \"min\": " << s.min << ", \"mean\": " << s.mean << ", \"p50\": " << s.p50 << ", \"p99\": " << s.p99
+           << ", \"max\": " << s.max << ", \"histogram\": [";
+        // Trailing empty buckets are omitted
+        const auto last = std::find_if(s.histogram.rbegin(), s.histogram.rend(), [](U64 n) { return n > 0; });
+        const U64 end = s.histogram.rend() - last;
+        for (U64 i = 0; i < end; ++i) {
+            os << (i > 0 ? ", " : "") << s.histogram[i];
+        }
+        os << "]}";
+    }
+    os << "]}";
+}
+
+} // namespace nvl
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @class Profiler
+ * @brief Collects per-frame timers and counters for coarse grained phases of the simulation.
+ *
+ * Each metric accumulates a value over the current frame (e.g. total nanoseconds spent in a phase during one tick).
+ * Calling end_frame() records the accumulated value into a rolling window of the last kHistory frames, from which
+ * summaries and histograms are computed on demand.
+ *
+ * Instrumentation is done with the profile_scope, profile_count, and profile_frame macros, which compile to nothing
+ * unless NVL_PROFILE is defined.
+ */
+class Profiler {
+public:
+    using Id = U64;
+    using Clock = std::chrono::steady_clock;
+
+#ifdef NVL_PROFILE
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    static constexpr U64 kHistory = 256; // Number of frames kept per metric
+    static constexpr U64 kBuckets = 40;  // Number of power-of-two histogram buckets
+
+    enum class Kind { kTimer, kCounter };
+
+    /// Rolling statistics for a single metric over the frames currently in its window.
+    struct Summary {
+        U64 frames = 0;
+        U64 calls = 0; // Total number of calls recorded within the window
+        U64 min = 0;
+        U64 mean = 0;
+        U64 p50 = 0;
+        U64 p99 = 0;
+        U64 max = 0;
+        U64 last = 0;
+        /// Number of frames with a value in [2^(i-1), 2^i), with bucket 0 holding frames with a value of 0.
+        std::array<U64, kBuckets> histogram{};
+    };
+
+    struct Metric {
+        std::string name;
+        Kind kind;
+        U64 value = 0; // Accumulated over the current frame
+        U64 calls = 0; // Number of updates in the current frame
+        std::array<U64, kHistory> history{};
+        std::array<U64, kHistory> history_calls{};
+    };
+
+    /// RAII timer which adds the time spent in its scope to a timer metric.
+    class Scope {
+    public:
+        explicit Scope(const Id id, Profiler &profiler = global()) : profiler_(profiler), id_(id) {}
+        ~Scope() { profiler_.add(id_, std::chrono::nanoseconds(Clock::now() - start_).count()); }
+
+    private:
+        Profiler &profiler_;
+        const Id id_;
+        const Clock::time_point start_ = Clock::now();
+    };
+
+    static Profiler &global();
+
+    /// Returns the id of the timer with the given name, registering it if it does not yet exist.
+    Id timer(std::string_view name) { return get_or_add(name, Kind::kTimer); }
+
+    /// Returns the id of the counter with the given name, registering it if it does not yet exist.
+    Id counter(std::string_view name) { return get_or_add(name, Kind::kCounter); }
+
+    /// Adds `value` to the metric `id` for the current frame.
+    void add(const Id id, const U64 value) {
+        Metric &metric = metrics_[id];
+        metric.value += value;
+        metric.calls += 1;
+    }
+
+    /// Records all values accumulated in the current frame and starts a new frame.
+    void end_frame();
+
+    /// Clears all recorded frames, keeping registered metrics.
+    void reset();
+
+    pure U64 frames() const { return frames_; }
+    pure const List<Metric> &metrics() const { return metrics_; }
+    pure const Metric &metric(const Id id) const { return metrics_[id]; }
+
+    /// Returns rolling statistics for the metric `id` over the last (up to) kHistory frames.
+    pure Summary summary(Id id) const;
+
+    /// Writes one row per recorded frame in the window with one column per metric.
+    void write_csv(std::ostream &os) const;
+
+    /// Writes a JSON object with the summary of each metric.
+    void write_json(std::ostream &os) const;
+
+private:
+    Id get_or_add(std::string_view name, Kind kind);
+
+    /// Returns the number of frames currently in the rolling window.
+    pure U64 window() const { return std::min(frames_, kHistory); }
+
+    U64 frames_ = 0;
+    List<Metric> metrics_;
+    Map<std::string, Id> ids_;
+};
+
+} // namespace nvl
+
+#define NVL_PROFILE_CONCAT_INNER(a, b) a##b
+#define NVL_PROFILE_CONCAT(a, b) NVL_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef NVL_PROFILE
+/// Times the remainder of the enclosing scope as the timer `name`.
+#define profile_scope(name)                                                                                            \
+    static const ::nvl::Profiler::Id NVL_PROFILE_CONCAT(profile_id_, __LINE__) =                                      \
+        ::nvl::Profiler::global().timer(name);                                                                        \
+    const ::nvl::Profiler::Scope NVL_PROFILE_CONCAT(profile_scope_, __LINE__)(NVL_PROFILE_CONCAT(profile_id_, __LINE__))
+
+/// Adds `n` to the counter `name`.
+#define profile_count(name, n)                                                                                         \
+    do {                                                                                                               \
+        static const ::nvl::Profiler::Id profile_id = ::nvl::Profiler::global().counter(name);                        \
+        ::nvl::Profiler::global().add(profile_id, n);                                                                  \
+    } while (0)
+
+/// Ends the current profiling frame.
+#define profile_frame() ::nvl::Profiler::global().end_frame()
+#else
+#define profile_scope(name) static_cast<void>(0)
+#define profile_count(name, n) static_cast<void>(0)
+#define profile_frame() static_cast<void>(0)
+#endif
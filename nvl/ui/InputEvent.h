@@ -1,5 +1,8 @@
 #pragma once
 
+#include <sstream>
+
+#include "nvl/data/Set.h"
 #include "nvl/macros/Abstract.h"
 #include "nvl/reflect/Castable.h"
 #include "nvl/ui/Key.h"
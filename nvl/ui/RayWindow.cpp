@@ -77,16 +77,10 @@ void RayWindow::feed() {
         events.push_back(InputEvent::get<MouseMove>(pressed_mouse_));
     }
 
-    for (auto iter = children_.begin(); iter != children_.end() && !events.empty(); ++iter) {
-        events = (*iter)->feed_all(events);
-    }
+    dispatch(std::move(events));
 }
 
-void RayWindow::tick() {
-    for (auto &child : children_) {
-        child->tick_all();
-    }
-}
+void RayWindow::tick() { tick_children(); }
 
 void RayWindow::line_rectangle(const Color &color, const Box<2> &box) {
     const Pos<2> shape = box.shape();
@@ -0,0 +1,207 @@
+#include "nvl/ui/Recording.h"
+
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+
+#include "nvl/macros/ReturnIf.h"
+#include "nvl/ui/Window.h"
+
+namespace nvl {
+
+namespace {
+
+/// Writes the event as "Name:value", where the value of a MouseMove is its comma separated buttons.
+void write_event(std::ostream &os, const InputEvent &event) {
+    if (const auto *key_up = event.dyn_cast<KeyUp>()) {
+        os << "KeyUp:" << static_cast<I64>(key_up->key.value);
+    } else if (const auto *key_down = event.dyn_cast<KeyDown>()) {
+        os << "KeyDown:" << static_cast<I64>(key_down->key.value);
+    } else if (const auto *mouse_up = event.dyn_cast<MouseUp>()) {
+        os << "MouseUp:" << static_cast<I64>(mouse_up->button.value);
+    } else if (const auto *mouse_down = event.dyn_cast<MouseDown>()) {
+        os << "MouseDown:" << static_cast<I64>(mouse_down->button.value);
+    } else if (const auto *mouse_scroll = event.dyn_cast<MouseScroll>()) {
+        os << "MouseScroll:" << static_cast<I64>(mouse_scroll->scroll.value);
+    } else if (const auto *mouse_move = event.dyn_cast<MouseMove>()) {
+        os << "MouseMove:";
+        bool first = true;
+        for (const Mouse &button : mouse_move->buttons) {
+            os << (first ? "" : ",") << static_cast<I64>(button.value);
+            first = false;
+        }
+    }
+}
+
+/// Returns `text` parsed as an integer, or None if it is not entirely an integer in the range of T.
+template <typename T>
+Maybe<T> parse(const std::string_view text) {
+    T value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return_if(error != std::errc() || end != text.data() + text.size(), None);
+    return value;
+}
+
+Maybe<InputEvent> read_event(const std::string &token) {
+    const U64 colon = token.find(':');
+    return_if(colon == std::string::npos, None);
+    const std::string name = token.substr(0, colon);
+    const std::string value = token.substr(colon + 1);
+    if (name == "MouseMove") {
+        Set<Mouse> buttons;
+        std::stringstream ss(value);
+        std::string button;
+        while (std::getline(ss, button, ',')) {
+            const Maybe<int> code = parse<int>(button);
+            return_if(!code.has_value(), None);
+            buttons.insert(*code);
+        }
+        return InputEvent::get<MouseMove>(buttons);
+    }
+    const Maybe<int> parsed = parse<int>(value);
+    return_if(!parsed.has_value(), None);
+    const int code = *parsed;
+    return_if(name == "KeyUp", InputEvent::get<KeyUp>(static_cast<Key::Value>(code)));
+    return_if(name == "KeyDown", InputEvent::get<KeyDown>(static_cast<Key::Value>(code)));
+    return_if(name == "MouseUp", InputEvent::get<MouseUp>(code));
+    return_if(name == "MouseDown", InputEvent::get<MouseDown>(code));
+    return_if(name == "MouseScroll", InputEvent::get<MouseScroll>(code));
+    return None;
+}
+
+} // namespace
+
+void Recording::feed(const Maybe<Pos<2>> &mouse, const Pos<2> &scroll, const List<InputEvent> &events) {
+    // Replaying a frame with no events and the same mouse and scroll state as the last one has no effect
+    const Frame *last = nullptr;
+    for (U64 i = frames.size(); i > 0 && last == nullptr; --i) {
+        last = frames[i - 1].tick ? nullptr : &frames[i - 1];
+    }
+    const bool same_state = last ? (last->mouse == mouse && last->scroll == scroll)
+                                 : (mouse == None && scroll == Pos<2>::zero);
+    return_if(events.empty() && same_state);
+    frames.push_back({.tick = false, .mouse = mouse, .scroll = scroll, .events = events});
+}
+
+U64 Recording::num_ticks() const {
+    U64 ticks = 0;
+    for (const Frame &frame : frames) {
+        ticks += frame.tick ? 1 : 0;
+    }
+    return ticks;
+}
+
+void Recording::write(std::ostream &os) const {
+    os << kMagic << " " << kVersion << std::endl;
+    os << "seed " << seed << std::endl;
+    os << "shape " << shape[0] << " " << shape[1] << std::endl;
+    for (U64 i = 0; i < frames.size(); ++i) {
+        const Frame &frame = frames[i];
+        if (frame.tick) {
+            U64 run = 1;
+            while (i + 1 < frames.size() && frames[i + 1].tick) {
+                ++run;
+                ++i;
+            }
+            os << "tick " << run << std::endl;
+            continue;
+        }
+        os << "feed ";
+        if (frame.mouse.has_value()) {
+            os << (*frame.mouse)[0] << " " << (*frame.mouse)[1];
+        } else {
+            os << "- -";
+        }
+        os << " " << frame.scroll[0] << " " << frame.scroll[1];
+        for (const InputEvent &event : frame.events) {
+            os << " ";
+            write_event(os, event);
+        }
+        os << std::endl;
+    }
+}
+
+Maybe<Recording> Recording::read(std::istream &is) {
+    Recording recording;
+    std::string magic, key;
+    U64 version = 0;
+    is >> magic >> version;
+    return_if(!is || magic != kMagic || version != kVersion, None);
+    is >> key >> recording.seed;
+    return_if(!is || key != "seed", None);
+    is >> key >> recording.shape[0] >> recording.shape[1];
+    return_if(!is || key != "shape", None);
+    is >> std::ws;
+
+    std::string line;
+    while (std::getline(is, line)) {
+        std::stringstream ss(line);
+        ss >> key;
+        if (key == "tick") {
+            U64 run = 0;
+            ss >> run;
+            return_if(!ss || run == 0, None);
+            for (U64 i = 0; i < run; ++i) {
+                recording.tick();
+            }
+        } else if (key == "feed") {
+            Frame frame;
+            std::string x, y;
+            ss >> x >> y >> frame.scroll[0] >> frame.scroll[1];
+            return_if(!ss, None);
+            if (x != "-" || y != "-") {
+                const Maybe<I64> mouse_x = parse<I64>(x);
+                const Maybe<I64> mouse_y = parse<I64>(y);
+                return_if(!mouse_x.has_value() || !mouse_y.has_value(), None);
+                frame.mouse = Pos<2>(*mouse_x, *mouse_y);
+            }
+            std::string token;
+            while (ss >> token) {
+                const Maybe<InputEvent> event = read_event(token);
+                return_if(!event.has_value(), None);
+                frame.events.push_back(*event);
+            }
+            recording.frames.push_back(std::move(frame));
+        } else {
+            return None;
+        }
+    }
+    return recording;
+}
+
+bool Recording::save(const std::string &path) const {
+    std::ofstream os(path);
+    return_if(!os, false);
+    write(os);
+    return static_cast<bool>(os);
+}
+
+Maybe<Recording> Recording::load(const std::string &path) {
+    std::ifstream is(path);
+    return_if(!is, None);
+    return read(is);
+}
+
+bool Replayer::step() {
+    while (next_ < recording_.frames.size()) {
+        const Recording::Frame &frame = recording_.frames[next_++];
+        if (frame.tick) {
+            window_->tick();
+            ++ticks_;
+            return true;
+        }
+        window_->replay(frame);
+    }
+    return false;
+}
+
+U64 Replayer::run() {
+    const U64 start = ticks_;
+    while (step()) {
+    }
+    return ticks_ - start;
+}
+
+} // namespace nvl
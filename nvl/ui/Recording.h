@@ -0,0 +1,84 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Maybe.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/ui/InputEvent.h"
+
+namespace nvl {
+
+class Window;
+
+/**
+ * @struct Recording
+ * @brief Log of everything which varies between runs of an interactive session: the seed of the world's random number
+ * generator, the window shape, the input fed to the window, and the boundaries between ticks.
+ *
+ * Replaying a recording (see Replayer) into a world created with the same seed reproduces the session exactly,
+ * independent of wall-clock pacing, so any recorded session can be used as a benchmark.
+ *
+ * Recordings are saved as text, with one line per frame and runs of ticks collapsed into a single line.
+ */
+struct Recording {
+    static constexpr std::string_view kMagic = "nvl-recording";
+    static constexpr U64 kVersion = 1;
+
+    struct Frame {
+        bool tick = false; // True if this frame is a tick, otherwise it feeds input to the window
+        Maybe<Pos<2>> mouse = None;
+        Pos<2> scroll = Pos<2>::zero;
+        List<InputEvent> events = {};
+    };
+
+    /// Records input fed to the window. Frames which do not change the window's input state are skipped.
+    void feed(const Maybe<Pos<2>> &mouse, const Pos<2> &scroll, const List<InputEvent> &events);
+
+    /// Records a tick boundary.
+    void tick() { frames.push_back({.tick = true}); }
+
+    pure U64 num_ticks() const;
+
+    void write(std::ostream &os) const;
+    static Maybe<Recording> read(std::istream &is);
+
+    /// Writes the recording to the file at `path`. Returns false if the file could not be written.
+    bool save(const std::string &path) const;
+
+    /// Reads the recording at `path`. Returns None if the file could not be read or is not a valid recording.
+    static Maybe<Recording> load(const std::string &path);
+
+    U64 seed = 0;
+    Pos<2> shape = Pos<2>::zero;
+    List<Frame> frames;
+};
+
+/**
+ * @class Replayer
+ * @brief Feeds a recording to a window (e.g. a NullWindow) as fast as possible.
+ */
+class Replayer {
+public:
+    explicit Replayer(const Recording &recording, Window *window) : recording_(recording), window_(window) {}
+
+    /// Feeds all input up to and including the next tick.
+    /// Returns false once the whole recording has been replayed.
+    bool step();
+
+    /// Replays the rest of the recording, returning the number of ticks replayed.
+    U64 run();
+
+    pure U64 ticks() const { return ticks_; }
+
+private:
+    const Recording &recording_;
+    Window *window_;
+    U64 next_ = 0;
+    U64 ticks_ = 0;
+};
+
+} // namespace nvl
@@ -10,4 +10,40 @@ Window::Offset::~Offset() { parent_->set_view_offset(prev_offset_); }
 
 Window::Window(std::string_view, Pos<2>) {}
 
+void Window::replay(const Recording::Frame &frame) {
+    for (const InputEvent &event : frame.events) {
+        if (const auto *key_up = event.dyn_cast<KeyUp>()) {
+            pressed_keys_.remove(key_up->key);
+        } else if (const auto *key_down = event.dyn_cast<KeyDown>()) {
+            pressed_keys_.insert(key_down->key);
+        } else if (const auto *mouse_up = event.dyn_cast<MouseUp>()) {
+            pressed_mouse_.remove(mouse_up->button);
+        } else if (const auto *mouse_down = event.dyn_cast<MouseDown>()) {
+            pressed_mouse_.insert(mouse_down->button);
+        }
+    }
+    scroll_ = frame.scroll;
+    prev_mouse_ = curr_mouse_;
+    curr_mouse_ = frame.mouse;
+    dispatch(frame.events);
+}
+
+void Window::dispatch(List<InputEvent> events) {
+    if (recording_ != nullptr) {
+        recording_->feed(curr_mouse_, scroll_, events);
+    }
+    for (auto iter = children_.begin(); iter != children_.end() && !events.empty(); ++iter) {
+        events = (*iter)->feed_all(events);
+    }
+}
+
+void Window::tick_children() {
+    if (recording_ != nullptr) {
+        recording_->tick();
+    }
+    for (auto &child : children_) {
+        child->tick_all();
+    }
+}
+
 } // namespace nvl
@@ -9,6 +9,7 @@
 #include "nvl/macros/Pure.h"
 #include "nvl/ui/Key.h"
 #include "nvl/ui/Mouse.h"
+#include "nvl/ui/Recording.h"
 #include "nvl/ui/Screen.h"
 
 namespace nvl {
@@ -89,6 +90,12 @@ public:
 
     pure virtual I64 fps() const = 0;
 
+    /// Records all input fed to this window and all ticks to `recording`, or stops recording if null.
+    void record(Recording *recording) { recording_ = recording; }
+
+    /// Feeds a recorded frame of input to this window in place of input from the user.
+    void replay(const Recording::Frame &frame);
+
     /// Returns the window view range in window coordinates.
     pure Box<2> bbox() const { return {{0, 0}, {width(), height()}}; }
 
@@ -98,6 +105,12 @@ public:
 protected:
     friend class Offset;
 
+    /// Feeds the given events to the children of this window, recording them first if recording.
+    void dispatch(List<InputEvent> events);
+
+    /// Ticks the children of this window, recording the tick first if recording.
+    void tick_children();
+
     Maybe<Pos<2>> offset_ = None;
 
     Set<Key> pressed_keys_;
@@ -109,6 +122,8 @@ protected:
     List<Screen> children_;
 
     MouseMode mouse_mode_ = MouseMode::kStandard;
+
+    Recording *recording_ = nullptr;
 };
 
 } // namespace nvl
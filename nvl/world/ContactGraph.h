@@ -0,0 +1,102 @@
+#pragma once
+
+#include "nvl/actor/Actor.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/geo/Box.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+
+namespace nvl {
+
+/**
+ * @class ContactGraph
+ * @brief Incrementally maintained graph of which entities rest on top of which others.
+ *
+ * Each contact between an entity and an entity directly below it is recorded once from each side, along with the
+ * touching segments. Updating an entity's contacts replaces both sides of all of its previous contacts, so only
+ * entities which move or change shape need to be updated for the graph to stay consistent.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ */
+template <U64 N>
+class ContactGraph {
+public:
+    /// Touching segments with each neighboring entity, as the bottom cells of the upper entity in world coordinates.
+    using Contacts = Map<Actor, List<Box<N>>>;
+
+    /// Replaces all contacts of `actor` with the given contacts above and below it.
+    void update(const Actor &actor, Contacts above, Contacts below) {
+        remove(actor);
+        for (const auto &[other, segments] : above) {
+            below_[other][actor] = segments;
+        }
+        for (const auto &[other, segments] : below) {
+            above_[other][actor] = segments;
+        }
+        if (!above.empty()) {
+            above_[actor] = std::move(above);
+        }
+        if (!below.empty()) {
+            below_[actor] = std::move(below);
+        }
+    }
+
+    /// Removes all contacts of `actor`.
+    void remove(const Actor &actor) {
+        unlink(above_, below_, actor);
+        unlink(below_, above_, actor);
+    }
+
+    /// Returns the entities directly above `actor`, and the segments of its top edges which they touch.
+    pure const Contacts &above(const Actor &actor) const { return get(above_, actor); }
+
+    /// Returns the entities directly below `actor`, and the segments of its bottom edges which they touch.
+    pure const Contacts &below(const Actor &actor) const { return get(below_, actor); }
+
+    pure bool has_above(const Actor &actor) const { return above_.has(actor); }
+    pure bool has_below(const Actor &actor) const { return below_.has(actor); }
+
+    /// Returns the total number of contacts (pairs of touching entities).
+    pure U64 size() const {
+        U64 size = 0;
+        for (const Contacts &contacts : below_.values()) {
+            size += contacts.size();
+        }
+        return size;
+    }
+
+    void clear() {
+        above_.clear();
+        below_.clear();
+    }
+
+private:
+    using Graph = Map<Actor, Contacts>;
+
+    /// Removes `actor` from `graph` and the reverse edges to it from `reverse`.
+    static void unlink(Graph &graph, Graph &reverse, const Actor &actor) {
+        if (const Contacts *contacts = graph.get(actor)) {
+            for (const auto &[other, _] : *contacts) {
+                if (Contacts *other_contacts = reverse.get(other)) {
+                    other_contacts->remove(actor);
+                    if (other_contacts->empty()) {
+                        reverse.remove(other);
+                    }
+                }
+            }
+            graph.remove(actor);
+        }
+    }
+
+    pure static const Contacts &get(const Graph &graph, const Actor &actor) {
+        static const Contacts kEmpty;
+        const Contacts *contacts = graph.get(actor);
+        return contacts ? *contacts : kEmpty;
+    }
+
+    Graph above_; // Entity => entities directly above it
+    Graph below_; // Entity => entities directly below it
+};
+
+} // namespace nvl
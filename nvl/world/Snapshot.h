@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "nvl/actor/Part.h"
+#include "nvl/data/List.h"
+#include "nvl/data/Map.h"
+#include "nvl/data/Maybe.h"
+#include "nvl/data/Range.h"
+#include "nvl/entity/Block.h"
+#include "nvl/entity/Entity.h"
+#include "nvl/io/MappedFile.h"
+#include "nvl/macros/Aliases.h"
+#include "nvl/macros/Pure.h"
+#include "nvl/macros/ReturnIf.h"
+#include "nvl/material/CustomMaterial.h"
+#include "nvl/material/Material.h"
+#include "nvl/world/World.h"
+
+namespace nvl {
+
+template <U64 N>
+class Block;
+
+/**
+ * @class Snapshot
+ * @brief Compact, versioned binary format for persisting the entities of a World.
+ *
+ * A snapshot is a header followed by three flat arrays of fixed size records:
+ *   Header | MaterialRecord[materials] | EntityRecord[entities] | PartRecord[parts]
+ *
+ * Materials are interned, so each distinct material is written once and parts refer to it by index. Each entity
+ * refers to a contiguous range of parts, in coordinates relative to the entity's location. All values are written in
+ * the native byte order, so snapshots are only portable between machines of the same endianness.
+ *
+ * Loading maps the file into memory and inserts all entities into the world at once. Entities are restored as Blocks.
+ *
+ * @tparam N Number of dimensions in the N-dimensional space.
+ */
+template <U64 N>
+class Snapshot {
+public:
+    static constexpr char kMagic[4] = {'N', 'V', 'L', 'S'};
+    static constexpr U32 kVersion = 1;
+    static constexpr U64 kMaxTypeName = 32;
+
+    struct Header {
+        char magic[4];
+        U32 version;
+        U32 dims;
+        U32 reserved;
+        U64 materials;
+        U64 entities;
+        U64 parts;
+    };
+
+    struct MaterialRecord {
+        char type[kMaxTypeName]; // Class name of the material, zero padded
+        U64 color;               // 0xRRGGBBAA
+        I64 durability;
+        U32 falls;
+        U32 outline;
+    };
+
+    struct EntityRecord {
+        I64 loc[N];
+        I64 velocity[N];
+        I64 accel[N];
+        U64 first_part;
+        U64 num_parts;
+    };
+
+    struct PartRecord {
+        I64 min[N];
+        I64 max[N];
+        I64 health;
+        U64 material; // Index into the material records
+    };
+
+    /// Streams the given entities to `os`.
+    static void write(const Range<Actor> &actors, std::ostream &os);
+
+    /// Streams all entities in `world` to `os`.
+    static void write(const World<N> &world, std::ostream &os) { write(world.actors().values(), os); }
+
+    /// Writes the given entities to the file at `path`. Returns false if the file could not be written.
+    static bool save(const Range<Actor> &actors, const std::string &path);
+
+    /// Writes all entities in `world` to the file at `path`. Returns false if the file could not be written.
+    static bool save(const World<N> &world, const std::string &path) { return save(world.actors().values(), path); }
+
+    /// Inserts all entities in the snapshot `bytes` into `world`.
+    /// Returns the number of entities loaded, or None if the bytes are not a valid snapshot of this version.
+    static Maybe<U64> read(World<N> &world, std::span<const char> bytes);
+
+    /// Maps the file at `path` into memory and inserts all entities in it into `world`.
+    /// Returns the number of entities loaded, or None if the file could not be read or is not a valid snapshot.
+    static Maybe<U64> load(World<N> &world, const std::string &path) {
+        const MappedFile file(path);
+        return_if(!file.valid(), None);
+        return read(world, file.bytes());
+    }
+
+private:
+    template <typename Record>
+    static void put(std::ostream &os, const Record &record) {
+        os.write(reinterpret_cast<const char *>(&record), sizeof(Record));
+    }
+
+    /// Reads the i-th record of an array starting at `offset`. Records are copied out since the bytes may be unaligned.
+    template <typename Record>
+    pure static Record get(const std::span<const char> bytes, const U64 offset, const U64 i = 0) {
+        Record record;
+        std::memcpy(&record, bytes.data() + offset + i * sizeof(Record), sizeof(Record));
+        return record;
+    }
+
+    pure static MaterialRecord to_record(const AbstractMaterial &material);
+
+    /// Returns the parts of `entity` in a canonical order, so that equal entities are always written identically.
+    pure static std::vector<const Part<N> *> sorted_parts(const Entity<N> &entity);
+
+    /// Returns an existing material with the same type and properties as `record`, or registers a new one.
+    static Material intern(const MaterialRecord &record);
+
+    /// Returns the box from `min` to `max`, or None if it is inverted in any dimension.
+    pure static Maybe<Box<N>> to_box(const I64 (&min)[N], const I64 (&max)[N]) {
+        return Box<N>::get(to_pos(min), to_pos(max));
+    }
+
+    pure static Pos<N> to_pos(const I64 (&pos)[N]) {
+        Pos<N> result;
+        for (U64 i = 0; i < N; ++i) {
+            result[i] = pos[i];
+        }
+        return result;
+    }
+
+    static void from_pos(I64 (&dst)[N], const Pos<N> &pos) {
+        for (U64 i = 0; i < N; ++i) {
+            dst[i] = pos[i];
+        }
+    }
+};
+
+template <U64 N>
+typename Snapshot<N>::MaterialRecord Snapshot<N>::to_record(const AbstractMaterial &material) {
+    MaterialRecord record = {};
+    const std::string_view name = material._get_classtag().name;
+    std::memcpy(record.type, name.data(), std::min<U64>(name.size(), kMaxTypeName - 1));
+    const Color &c = material.color;
+    record.color = (c.r & 0xFF) << 24 | (c.g & 0xFF) << 16 | (c.b & 0xFF) << 8 | (c.a & 0xFF);
+    record.durability = material.durability;
+    record.falls = material.falls;
+    record.outline = material.outline;
+    return record;
+}
+
+template <U64 N>
+Material Snapshot<N>::intern(const MaterialRecord &record) {
+    const Color color = {.r = (record.color >> 24) & 0xFF,
+                         .g = (record.color >> 16) & 0xFF,
+                         .b = (record.color >> 8) & 0xFF,
+                         .a = record.color & 0xFF};
+    const MaterialTable::Key key = {.type = std::string_view(record.type, strnlen(record.type, kMaxTypeName)),
+                                    .color = color,
+                                    .durability = record.durability,
+                                    .falls = record.falls != 0,
+                                    .outline = record.outline != 0};
+    if (const Maybe<MaterialTable::Id> id = MaterialTable::global().find(key)) {
+        return Material(*id);
+    }
+    return Material::get<CustomMaterial>(color, record.durability, key.falls, key.outline);
+}
+
+template <U64 N>
+std::vector<const Part<N> *> Snapshot<N>::sorted_parts(const Entity<N> &entity) {
+    std::vector<const Part<N> *> parts;
+    for (const Ref<Part<N>> &part : entity.relative.parts()) {
+        parts.push_back(part.ptr());
+    }
+    std::sort(parts.begin(), parts.end(), [](const Part<N> *a, const Part<N> *b) {
+        for (U64 i = 0; i < N; ++i) {
+            return_if(a->box.min[i] != b->box.min[i], a->box.min[i] < b->box.min[i]);
+        }
+        for (U64 i = 0; i < N; ++i) {
+            return_if(a->box.max[i] != b->box.max[i], a->box.max[i] < b->box.max[i]);
+        }
+        return false;
+    });
+    return parts;
+}
+
+template <U64 N>
+void Snapshot<N>::write(const Range<Actor> &actors, std::ostream &os) {
+    // First pass: intern materials and count parts so that the header can be written up front
+    Map<Material, U64> material_index;
+    List<Material> materials;
+    U64 num_entities = 0;
+    U64 num_parts = 0;
+    for (const Actor &actor : actors) {
+        const auto *entity = actor.dyn_cast<Entity<N>>();
+        for (const Ref<Part<N>> &part : entity->relative.parts()) {
+            if (!material_index.has(part->material)) {
+                material_index[part->material] = materials.size();
+                materials.push_back(part->material);
+            }
+            num_parts += 1;
+        }
+        num_entities += 1;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dims = N;
+    header.materials = materials.size();
+    header.entities = num_entities;
+    header.parts = num_parts;
+    put(os, header);
+
+    for (const Material &material : materials) {
+        put(os, to_record(*material));
+    }
+
+    U64 first_part = 0;
+    for (const Actor &actor : actors) {
+        const auto *entity = actor.dyn_cast<Entity<N>>();
+        EntityRecord record = {};
+        from_pos(record.loc, entity->loc());
+        from_pos(record.velocity, entity->velocity());
+        from_pos(record.accel, entity->accel());
+        record.first_part = first_part;
+        record.num_parts = entity->tree().size();
+        first_part += record.num_parts;
+        put(os, record);
+    }
+
+    for (const Actor &actor : actors) {
+        const auto *entity = actor.dyn_cast<Entity<N>>();
+        for (const Part<N> *part : sorted_parts(*entity)) {
+            PartRecord record = {};
+            from_pos(record.min, part->box.min);
+            from_pos(record.max, part->box.max);
+            record.health = part->health;
+            record.material = material_index.at(part->material);
+            put(os, record);
+        }
+    }
+}
+
+template <U64 N>
+bool Snapshot<N>::save(const Range<Actor> &actors, const std::string &path) {
+    std::ofstream os(path, std::ios::binary);
+    return_if(!os, false);
+    write(actors, os);
+    return static_cast<bool>(os);
+}
+
+template <U64 N>
+Maybe<U64> Snapshot<N>::read(World<N> &world, const std::span<const char> bytes) {
+    return_if(bytes.size() < sizeof(Header), None);
+    const auto header = get<Header>(bytes, 0);
+    return_if(std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0, None);
+    return_if(header.version != kVersion || header.dims != N, None);
+
+    // Counts are untrusted, so bound them by the size of the snapshot before computing offsets from them
+    const U64 size = bytes.size();
+    return_if(header.materials > size / sizeof(MaterialRecord) || header.entities > size / sizeof(EntityRecord) ||
+                  header.parts > size / sizeof(PartRecord),
+              None);
+    const U64 materials_offset = sizeof(Header);
+    const U64 entities_offset = materials_offset + header.materials * sizeof(MaterialRecord);
+    const U64 parts_offset = entities_offset + header.entities * sizeof(EntityRecord);
+    const U64 end = parts_offset + header.parts * sizeof(PartRecord);
+    return_if(end != size, None);
+
+    List<Material> materials;
+    for (U64 i = 0; i < header.materials; ++i) {
+        materials.push_back(intern(get<MaterialRecord>(bytes, materials_offset, i)));
+    }
+
+    std::vector<std::unique_ptr<Entity<N>>> entities;
+    entities.reserve(header.entities);
+    List<Part<N>> parts;
+    List<Ref<Part<N>>> refs;
+    for (U64 i = 0; i < header.entities; ++i) {
+        const auto record = get<EntityRecord>(bytes, entities_offset, i);
+        return_if(record.first_part > header.parts || record.num_parts > header.parts - record.first_part, None);
+        parts.clear();
+        for (U64 j = record.first_part; j < record.first_part + record.num_parts; ++j) {
+            const auto part = get<PartRecord>(bytes, parts_offset, j);
+            const Maybe<Box<N>> box = to_box(part.min, part.max);
+            return_if(part.material >= materials.size() || !box.has_value() || !Part<N>::fits(*box), None);
+            parts.emplace_back(*box, materials[part.material], part.health);
+        }
+        // Refer to the parts only once all have been added, since adding parts may reallocate the list
+        refs.clear();
+        for (Part<N> &part : parts) {
+            refs.emplace_back(part);
+        }
+        auto entity = std::make_unique<Block<N>>(to_pos(record.loc), refs.range());
+        entity->set_velocity(to_pos(record.velocity));
+        entity->set_accel(to_pos(record.accel));
+        entities.push_back(std::move(entity));
+    }
+    world.reify(std::move(entities));
+    return header.entities;
+}
+
+} // namespace nvl
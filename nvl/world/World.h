@@ -1,42 +1,101 @@
 #pragma once
 
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "nvl/actor/Actor.h"
+#include "nvl/actor/Part.h"
+#include "nvl/data/Concat.h"
 #include "nvl/data/Map.h"
 #include "nvl/data/Set.h"
+#include "nvl/data/SlotMap.h"
+#include "nvl/data/SlotSet.h"
+#include "nvl/data/TimerWheel.h"
 #include "nvl/geo/Box.h"
+#include "nvl/geo/HashGrid.h"
 #include "nvl/geo/RTree.h"
+#include "nvl/geo/SpatialIndex.h"
 #include "nvl/material/Bulwark.h"
 #include "nvl/math/Random.h"
 #include "nvl/message/Created.h"
 #include "nvl/message/Destroy.h"
+#include "nvl/message/Hit.h"
 #include "nvl/message/Message.h"
+#include "nvl/message/Notify.h"
+#include "nvl/time/Duration.h"
+#include "nvl/time/Profiler.h"
 #include "nvl/ui/Screen.h"
 #include "nvl/ui/Window.h"
+#include "nvl/world/ContactGraph.h"
 
 namespace nvl {
 
 template <U64 N>
 class Entity;
 
+template <U64 N>
+class Block;
+
+template <U64 N>
+class Snapshot;
+
 template <U64 N>
 class World : public AbstractScreen {
 public:
     class_tag(World<N>, AbstractScreen);
 
+    /// Spatial index used for entities (see EntityIndex).
+    enum class IndexKind {
+        kTree,    // Hierarchical grid (RTree), which suits large or sparse worlds
+        kHashGrid // Uniform hash grid (HashGrid), which suits many small entities of a similar size
+    };
+
     struct Params {
         Params() {}
-        U64 terminal_velocity = 53;  // meters/sec (default is about 120mph)
-        U64 gravity_accel = 2;       // meters/sec^2
-        I64 maximum_y = 1e3;         // meters -- down is positive
-        U64 pixels_per_meter = 1000; // pixels / meter
-        U64 ms_per_tick = 30;        // milliseconds / tick
+        U64 terminal_velocity = 53;         // meters/sec (default is about 120mph)
+        U64 gravity_accel = 2;              // meters/sec^2
+        I64 maximum_y = 1e3;                // meters -- down is positive
+        U64 pixels_per_meter = 1000;        // pixels / meter
+        U64 ms_per_tick = 30;               // milliseconds / tick
+        U64 active_screens = 0;             // screens around the view which are ticked (0 ticks everything)
+        U64 inactive_period = 0;            // ticks between ticks outside the active region (0 freezes them)
+        U64 resident_chunks = 0;            // chunks kept in memory when streaming (0 keeps the whole world in memory)
+        std::string page_dir = "";          // where the world makes its directory of pages (empty: temp directory)
+        U64 seed = 0;                       // seed of the random number generator (0 seeds from the OS)
+        U64 history = 0;                    // ticks which can be restored (0 keeps no history)
+        IndexKind index = IndexKind::kTree; // spatial index of entities
     };
 
     static constexpr I64 kMaxEntries = 10;
     static constexpr I64 kGridExpMin = 2;
     static constexpr I64 kGridExpMax = 10;
     static constexpr U64 kVerticalDim = 1;
+    static constexpr U64 kHashCellExp = 5;
     using EntityTree = RTree<N, Entity<N>, Actor, kMaxEntries, kGridExpMin, kGridExpMax>;
+    using EntityGrid = HashGrid<N, Entity<N>, Actor, kHashCellExp>;
+    using EntityIndex = AnyIndex<N, Entity<N>, Actor, EntityTree, EntityGrid>;
+
+    /// The static index is rebuilt once the number of edits since the last rebuild exceeds 1/kStaticRebuildRatio of
+    /// the static entities, or kStaticRebuildMin edits, whichever is larger.
+    static constexpr U64 kStaticRebuildRatio = 8;
+    static constexpr U64 kStaticRebuildMin = 16;
+
+    /// The world is streamed in chunks aligned with the root grid of the entity index. Each entity belongs to the
+    /// chunk containing the minimum corner of its bounding box.
+    static constexpr I64 kChunkSize = I64(1) << kGridExpMax;
+
+    /// Ticks between checks for chunks to evict, since finding the resident chunks scans all entities.
+    static constexpr U64 kEvictPeriod = 16;
 
     const I64 kMillisPerTick;  // ms / tick
     const I64 kNanosPerTick;   // ns / tick
@@ -47,6 +106,14 @@ public:
     const Pos<N> kGravity;   // pixels / tick^2
     const I64 kMaxY;         // pixels
 
+    const U64 kActiveScreens;  // screens
+    const U64 kInactivePeriod; // ticks
+
+    const U64 kResidentChunks; // chunks
+    const std::string kPageDir; // Directory in which the directory of pages is made
+
+    const U64 kHistory; // ticks
+
     pure static bool is_up(const U64 dim, const Dir dir) { return dim == kVerticalDim && dir == Dir::Neg; }
     pure static bool is_down(const U64 dim, const Dir dir) { return dim == kVerticalDim && dir == Dir::Pos; }
 
@@ -56,7 +123,18 @@ public:
           kGravityAccel(params.gravity_accel * kPixelsPerMeter * kMillisPerTick * kMillisPerTick / 1e6),
           kMaxVelocity(params.terminal_velocity * kMillisPerTick * kPixelsPerMeter / 1e3),
           kGravity(Pos<N>::unit(kVerticalDim, kGravityAccel)), // Gravity as a vector
-          kMaxY(params.maximum_y * kPixelsPerMeter) {
+          kMaxY(params.maximum_y * kPixelsPerMeter), kActiveScreens(params.active_screens),
+          kInactivePeriod(params.inactive_period), kResidentChunks(params.resident_chunks),
+          kPageDir(params.page_dir), kHistory(params.history),
+          random(params.seed != 0 ? Random(params.seed) : Random()) {
+        if (params.index == IndexKind::kHashGrid) {
+            static_.template reset<EntityGrid>();
+            dynamic_.template reset<EntityGrid>();
+        }
+        if (has_history()) {
+            history_.resize(kHistory);
+            begin_delta();
+        }
 
         on_mouse_move[{}] = on_mouse_move[{Mouse::Any}] = [this] {
             propagate_event(); // Don't prevent children from seeing the mouse movement event
@@ -66,14 +144,90 @@ public:
         // std::cout << "MaxVelocity: " << kMaxVelocity << " pixels / tick" << std::endl;
     }
 
-    pure Range<Actor> entities(const Pos<N> &pos) { return entities_[pos]; }
-    pure Range<Actor> entities(const Box<N> &box) { return entities_[box]; }
+    /// Waits for any pages which are being read, and removes the directory of pages along with all pages in it.
+    ~World() override;
+
+    pure Range<Actor> entities(const Pos<N> &pos) { return entities(Box<N>::unit(pos)); }
+    pure Range<Actor> entities(const Box<N> &box) { return concat<Actor>(static_[box], dynamic_[box]); }
+
+    /// Calls `f(i, actor)` once for each entity overlapping the i-th box, e.g. to find the neighbors of all parts of an
+    /// entity at once. See RTree::query_many.
+    template <typename F>
+    void query_many(const Range<Box<N>> &boxes, F &&f) const {
+        static_.query_many(boxes, f);
+        dynamic_.query_many(boxes, f);
+    }
+
+    /// Returns the index of entities which never fall (e.g. terrain), or the index of all other entities.
+    pure const EntityIndex &static_entities() const { return static_; }
+    pure const EntityIndex &dynamic_entities() const { return dynamic_; }
+
+    /// Returns true if the given actor is held in the static index.
+    pure bool is_static(const Actor &actor) const { return static_.has(actor); }
 
     pure Pos<2> view() const { return view_; }
     void set_hud(const bool enable) { hud_ = enable; }
 
     pure U64 num_awake() const { return awake_.size(); }
-    pure U64 num_alive() const { return entities_.size(); }
+    pure U64 num_alive() const { return actors_.size(); }
+
+    /// Returns all entities in the world, stored densely by id.
+    pure const SlotMap<Actor> &actors() const { return actors_; }
+
+    /// Returns true if the actor is alive in this world. Handles to entities which have died are stale.
+    pure bool has(const Actor &actor) const { return actors_.has(actor.id()); }
+    pure U64 num_asleep() const { return supports_.size(); }
+
+    /// Returns true if the given actor is asleep, i.e. resting and not ticked until disturbed.
+    pure bool is_asleep(const Actor &actor) const { return supports_.has(actor); }
+
+    /// Returns the number of awake entities which were not ticked in the last tick for being outside the active region.
+    pure U64 num_inactive() const { return num_inactive_; }
+
+    /// Adds a volume which is always ticked, in addition to the region around the view.
+    void add_interest(const Box<N> &box) { interests_.push_back(box); }
+    void clear_interests() { interests_.clear(); }
+
+    /// Returns true if only entities within the active region are ticked every tick.
+    pure bool has_active_region() const { return kActiveScreens > 0 || !interests_.empty(); }
+
+    /// Returns the volumes in which entities are ticked every tick: the region of kActiveScreens screens around the
+    /// view, and each point of interest. Dimensions other than those of the view are unbounded.
+    pure List<Box<N>> active_region() const;
+
+    /// Returns true if chunks far from the active region are paged out to disk to stay within the memory budget.
+    pure bool is_streaming() const { return kResidentChunks > 0 && has_active_region(); }
+
+    /// Returns the chunk containing the given bounding box, identified by its minimum corner.
+    pure static Pos<N> chunk(const Box<N> &bbox) { return bbox.min.grid_min(kChunkSize); }
+    pure static Box<N> chunk_box(const Pos<N> &chunk) { return {chunk, chunk + (kChunkSize - 1)}; }
+
+    /// Returns the number of chunks which are paged out to disk, including any which are being loaded.
+    pure U64 num_paged() const { return pages_.size() + loading_.size(); }
+
+    /// Returns true if the given chunk (or part of it) is paged out to disk.
+    pure bool is_paged(const Pos<N> &chunk) const { return pages_.has(chunk) || loading_.has(chunk); }
+
+    /// Blocks until all chunks which are being loaded have been read, and inserts their entities.
+    void await_pages() { insert_pages(/*wait=*/true); }
+
+    /// Returns the number of ticks the world has run for.
+    pure U64 ticks() const { return ticks_; }
+
+    /// Returns true if the last kHistory ticks are kept so that they can be restored.
+    pure bool has_history() const { return kHistory > 0; }
+
+    /// Returns true if the world can be restored to its state at the start of the given tick.
+    pure bool can_restore(U64 tick) const;
+
+    /// Restores the world to its state at the start of the given tick, i.e. when ticks() was `tick`, by undoing the
+    /// changes of each tick since. Entities which died since are recreated (as Blocks) with new handles. Scheduled
+    /// messages which became due since are scheduled again, and those scheduled since are discarded.
+    /// Returns false if the tick is not one of the last kHistory ticks.
+    bool restore(U64 tick);
+
+    /// Returns the graph of entities resting directly on top of each other.
+    pure const ContactGraph<N> &contacts() const { return contacts_; }
 
     /// Converts the given coordinates from window coordinates to world coordinates.
     pure Pos<2> window_to_world(const Pos<2> &pos) const { return pos + view_; }
@@ -84,7 +238,7 @@ public:
     template <typename Msg, typename... Args>
     void send(const Actor src, const Actor &dst, Args &&...args) {
         const auto message = Message::get<Msg>(src, std::forward<Args>(args)...);
-        if (entities_.has(dst)) {
+        if (has(dst) && should_deliver(dst, message)) {
             messages_[dst].push_back(std::move(message));
         }
     }
@@ -93,39 +247,75 @@ public:
     void send(const Actor src, const Range<Actor> &dst, Args &&...args) {
         const auto message = Message::get<Msg>(src, std::forward<Args>(args)...);
         for (const Actor &actor : dst) {
-            if (entities_.has(actor)) {
+            if (has(actor) && should_deliver(actor, message)) {
                 messages_[actor].push_back(message);
             }
         }
     }
 
+    /// Delivers `message` to `actor` at the start of the tick `ticks` ticks from now, waking it if it is asleep.
+    /// Actors waiting for a scheduled message can sleep (or idle) until then at no cost. Messages scheduled for
+    /// actors which have since died are dropped.
+    void schedule(const Actor &actor, const U64 ticks, Message message) {
+        const U64 id = timers_.schedule(ticks, {actor, std::move(message)});
+        num_timers_[actor] += 1;
+        if (has_history()) {
+            delta().scheduled.push_back(id);
+        }
+    }
+
+    /// Returns the number of scheduled messages which have not been delivered yet.
+    pure U64 num_scheduled() const { return timers_.size(); }
+
     /// Inserts a copy of this entity into the world.
     /// Returns a reference to the resulting copy.
+    /// Entities which never fall are held in the static index, and all others in the dynamic index.
     Actor reify(std::unique_ptr<Entity<N>> entity) {
-        Actor result = entities_.take(std::move(entity));
-        Entity<N> *copy = result.template dyn_cast<Entity<N>>();
-        awake_.emplace(copy);
-        copy->bind(this);
-        return result;
+        const Actor actor = insert(std::move(entity));
+        update_contacts(actor.template dyn_cast<Entity<N>>());
+        return actor;
+    }
+
+    /// Inserts all of the given entities at once, e.g. when loading a snapshot.
+    /// Each index takes all of its entities at once, so that it can be built in one pass (see RTree::take), and
+    /// contacts are computed once all entities are in place rather than as each entity is inserted.
+    List<Actor> reify(std::vector<std::unique_ptr<Entity<N>>> entities) {
+        std::vector<std::unique_ptr<Entity<N>>> statics, dynamics;
+        std::vector<bool> falls;
+        for (std::unique_ptr<Entity<N>> &entity : entities) {
+            entity->set_id(actors_.insert(nullptr));
+            falls.push_back(entity->falls());
+            (entity->falls() ? dynamics : statics).push_back(std::move(entity));
+        }
+        const List<Actor> taken_static = static_.take(std::move(statics));
+        const List<Actor> taken_dynamic = dynamic_.take(std::move(dynamics));
+
+        // Return the actors in the order of the given entities
+        List<Actor> actors;
+        U64 next_static = 0, next_dynamic = 0;
+        for (const bool is_dynamic : falls) {
+            const Actor &actor = is_dynamic ? taken_dynamic[next_dynamic++] : taken_static[next_static++];
+            admit(actor);
+            actors.push_back(actor);
+        }
+        for (const Actor &actor : actors) {
+            const auto *entity = actor.template dyn_cast<Entity<N>>();
+            update_contacts(entity);
+            if (!supports_.empty()) {
+                relink_dependents(entity);
+            }
+        }
+        return actors;
     }
 
     template <typename T, typename... Args>
     Actor spawn(Args &&...args) {
-        Actor actor = entities_.template emplace<T>(std::forward<Args>(args)...);
-        if (Entity<N> *entity = actor.template dyn_cast<Entity<N>>()) {
-            awake_.emplace(entity);
-            entity->bind(this);
-        }
-        return actor;
+        return reify(std::make_unique<T>(std::forward<Args>(args)...));
     }
 
     template <typename T, typename... Args>
     Actor spawn_by(const Actor src, Args &&...args) {
-        Actor actor = entities_.template emplace<T>(std::forward<Args>(args)...);
-        if (Entity<N> *entity = actor.template dyn_cast<Entity<N>>()) {
-            awake_.emplace(entity);
-            entity->bind(this);
-        }
+        Actor actor = reify(std::make_unique<T>(std::forward<Args>(args)...));
         if (src != nullptr) {
             send<Created>(src, actor);
         }
@@ -142,34 +332,793 @@ public:
 protected:
     using EntityHash = PointerHash<Ref<Entity<N>>>;
 
+    void tick_all();
     void tick_entity(Set<Actor> &idled, Ref<Entity<N>> entity);
 
-    EntityTree entities_;
-    Set<Actor> awake_;
+    /// Integrates the velocity and acceleration of the entities which may be in free fall in a batch. See FreeFall.
+    void integrate(const List<Actor> &entities);
+
+    /// Moves the i-th entity being ticked by its integrated velocity if nothing is within reach of its path.
+    /// Returns false if the entity must be ticked instead.
+    bool fall(Ref<Entity<N>> entity, U64 i);
+
+    /// Returns the awake entities to tick this tick.
+    /// Entities outside the active region are skipped (keeping their state and pending messages) unless this is one of
+    /// their reduced rate ticks.
+    List<Actor> active_entities();
+    void draw_profile(I64 y) const;
+
+    /// Pages chunks out to disk or back in as the active region moves. See is_streaming.
+    void stream();
+
+    /// Returns the active region, grown by a chunk on all sides so that chunks are loaded before they are needed.
+    pure List<Box<N>> stream_region() const;
+
+    /// Starts reading the pages of the chunk in the background.
+    void load_chunk(const Pos<N> &chunk);
+
+    /// Inserts the entities of all chunks which have finished loading, optionally waiting for all pending loads.
+    void insert_pages(bool wait);
+
+    /// Pages out the most distant chunks outside the stream region until at most kResidentChunks remain.
+    void evict_chunks(const List<Box<N>> &region);
+
+    /// Writes the entities of a chunk to a new page and removes them from the world.
+    /// If the page cannot be written, the failure is reported and the chunk is kept in memory.
+    void evict_chunk(const Pos<N> &chunk, const List<Actor> &actors);
+
+    /// Makes the directory of pages of this world, unless it already exists. Returns false if it could not be made.
+    bool make_page_dir();
+
+    /// Removes the entity from the world without it dying, e.g. when its chunk is paged out.
+    /// Anything sleeping on the entity is left asleep, so islands which straddle the edge of a chunk are not woken.
+    /// They are linked to the entity again once its chunk is loaded (see relink_dependents).
+    void evict(const Actor &actor);
+
+    /// Links entities sleeping directly on the entity to it, in place of any supports which are no longer in the world.
+    /// Entities which are paged back in get new handles, so sleepers which rested on them would otherwise never see
+    /// them move or die.
+    void relink_dependents(const Entity<N> *entity);
+
+    using Timers = TimerWheel<std::pair<Actor, Message>>;
+    using Timer = typename Timers::Entry;
+
+    /// State of an entity at the start of a tick, before it was ticked.
+    struct EntityState {
+        Actor actor;
+        Pos<N> loc;
+        Pos<N> velocity;
+        Pos<N> accel;
+        Maybe<List<Part<N>>> parts = None; // Only kept if the entity had pending messages, since only messages change parts
+    };
+
+    /// Changes made to the world since the start of a tick, with enough state to undo them.
+    /// Only entities which were ticked are copied, and pending messages are shared rather than copied.
+    struct Delta {
+        U64 tick = std::numeric_limits<U64>::max();
+        List<EntityState> changed;          // Entities ticked during the tick, in the order they were ticked
+        List<Actor> spawned;                // Entities inserted during the tick
+        Map<Actor, List<Message>> messages; // Messages pending at the start of the tick
+        List<U64> scheduled;                // Ids of the messages scheduled during the tick
+        List<Timer> fired;                  // Scheduled messages which became due at the start of the tick
+    };
+
+    /// Starts recording the changes of the current tick, replacing the oldest delta in the history.
+    void begin_delta();
+
+    /// Returns the delta of the current tick.
+    pure Delta &delta() { return history_[ticks_ % kHistory]; }
+
+    /// Saves the state of the entity in the current delta before it is ticked.
+    void save_state(const Entity<N> *entity);
+
+    /// Returns the index holding the given actor.
+    pure EntityIndex &index(const Actor &actor) { return static_.has(actor) ? static_ : dynamic_; }
+
+    /// Updates the static index after the entity changed shape, moving it to the dynamic index if it now falls.
+    void update_static(Ref<Entity<N>> entity, const Box<N> &prev_bbox);
+
+    /// Rebuilds the static index if it has been edited enough since the last rebuild.
+    void maybe_rebuild_static();
+
+    /// Takes ownership of the entity and registers it as awake, without computing its contacts.
+    Actor insert(std::unique_ptr<Entity<N>> entity) {
+        // Reserve the id before taking ownership so that all handles to the entity carry its id
+        const SlotId id = actors_.insert(nullptr);
+        entity->set_id(id);
+        EntityIndex &tree = entity->falls() ? dynamic_ : static_;
+        const Actor actor = tree.take(std::move(entity));
+        admit(actor);
+        return actor;
+    }
+
+    /// Registers an entity which was just taken by one of the indices as alive and awake.
+    void admit(Actor actor) {
+        *actors_.get(actor.id()) = actor;
+        awake_.insert(actor);
+        actor.template dyn_cast<Entity<N>>()->bind(this);
+        if (has_history()) {
+            delta().spawned.push_back(actor);
+        }
+    }
+
+    /// Recomputes the contacts of the entity, e.g. after it was created, moved, or changed shape.
+    void update_contacts(const Entity<N> *entity);
+
+    /// Returns false if the message can be dropped without waking its destination.
+    /// Sleeping entities only need to see notifications from the entities they rest on.
+    pure bool should_deliver(const Actor &dst, const Message &message) const {
+        const Set<Actor> *supports = supports_.get(dst);
+        return supports == nullptr || !message.isa<Notify>() || supports->has(message->src);
+    }
+
+    /// Puts the entity to sleep if it is resting on something (or does not fall).
+    void sleep(const Actor &actor);
+
+    /// Wakes the entity if it is asleep.
+    void wake(const Actor &actor);
+
+    /// Wakes all sleeping entities resting on this one, directly or indirectly.
+    void wake_dependents(const Actor &actor);
+
+    // Large maps are mostly immovable terrain, so entities which never fall are kept in a separate index which is
+    // only edited when terrain is hit or destroyed, and periodically rebuilt to stay compact. Everything else is kept
+    // in a (typically much smaller) dynamic index which is updated as entities move. Terrain is indexed with the loose
+    // layout, so that large blocks are listed once rather than in every cell they overlap.
+    EntityIndex static_{std::in_place_type<EntityTree>, EntityTree::Layout::kLoose};
+    EntityIndex dynamic_;
+    U64 static_edits_ = 0; // Number of edits to the static index since it was last rebuilt
+    ContactGraph<N> contacts_;
+    SlotMap<Actor> actors_;
+    SlotSet<Actor> awake_;
     Set<Actor> died_;
+    Set<Actor> moved_;
     Map<Actor, List<Message>> messages_;
+    Timers timers_;              // Scheduled messages
+    Map<Actor, U64> num_timers_; // Actor => number of its scheduled messages which have not become due yet
+
+    // Most awake entities are in free fall with nothing in their path. Rather than ticking each of them, the motion of
+    // all entities which may be in free fall is integrated up front over contiguous arrays, with one entry per entity
+    // being ticked. Each is then moved directly if a single query of the index finds nothing within reach of its path,
+    // and only those near contact are ticked.
+    struct FreeFall {
+        std::vector<U8> candidate; // 1 if the entity may be in free fall
+        std::array<std::vector<I64>, N> velocity;
+        std::array<std::vector<I64>, N> accel;
+    };
+    FreeFall free_fall_;
+
+    // Sleeping entities form islands of resting entities linked by contact. Each sleeping entity records the entities
+    // directly below it, and each supporting entity records the sleeping entities directly above it. An island is
+    // only woken when one of its supports moves, dies, or notifies it.
+    Map<Actor, Set<Actor>> supports_;   // Sleeping entity => entities it rests on
+    Map<Actor, Set<Actor>> dependents_; // Entity => sleeping entities resting on it
+
+    // Simulation level of detail: awake entities outside the active region are frozen or ticked at a reduced rate
+    List<Box<N>> interests_;
+    U64 ticks_ = 0;
+    U64 num_inactive_ = 0;
+
+    // Streaming: chunks outside the memory budget are written to page files and their entities removed. A chunk may
+    // have several pages if entities moved into it after it was paged out. Pages are read in the background once the
+    // active region nears them, and inserted at the end of the next tick after they have been read.
+    // Each world writes its pages to a directory of its own, so that worlds sharing a page_dir never overwrite each
+    // other's pages. Pages which cannot be read are left on disk and the chunk stays paged, so loading is retried.
+    using Page = std::pair<std::string, std::string>;     // Path and contents of a page
+    Map<Pos<N>, List<std::string>> pages_;                // Chunk => page files
+    Map<Pos<N>, std::shared_future<List<Page>>> loading_; // Chunk => its pages, once read
+    std::string page_path_;                               // Directory of pages, made when a chunk is first paged out
+    Set<std::string> unreadable_;                         // Pages which could not be read, only reported once
+    U64 next_page_ = 0;
+
+    // Rollback: a ring buffer of the deltas of the last kHistory ticks, indexed by tick
+    std::vector<Delta> history_;
 
     Pos<2> view_ = Pos<2>::zero;
     bool hud_ = true;
 };
 
+template <U64 N>
+World<N>::~World() {
+    for (const auto &[_, future] : loading_) {
+        future.wait();
+    }
+    if (!page_path_.empty()) {
+        std::error_code error;
+        std::filesystem::remove_all(page_path_, error);
+    }
+}
+
 template <U64 N>
 void World<N>::tick() {
-    // Wake any entities with pending messages
-    for (auto &[actor, _] : messages_) {
-        awake_.emplace(actor);
+    {
+        profile_scope("world.tick");
+        tick_all();
+    }
+    profile_frame();
+}
+
+template <U64 N>
+void World<N>::tick_all() {
+    {
+        profile_scope("world.timers");
+        for (const Timer &timer : timers_.expire()) {
+            const auto &[actor, message] = timer.value;
+            if (U64 &count = num_timers_[actor]; --count == 0) {
+                num_timers_.remove(actor);
+            }
+            if (has(actor)) {
+                messages_[actor].push_back(message);
+            }
+            if (has_history()) {
+                delta().fired.push_back(timer);
+            }
+        }
     }
+    {
+        // Wake any entities with pending messages
+        profile_scope("world.wake");
+        for (auto &[actor, _] : messages_) {
+            wake(actor);
+        }
+    }
+    profile_count("world.awake", awake_.size());
 
+    // Iterate over a snapshot since entities may spawn new (awake) entities while ticking
+    const List<Actor> awake = active_entities();
+    integrate(awake);
     Set<Actor> idled;
-    for (Actor actor : awake_) {
+    for (U64 i = 0; i < awake.size(); ++i) {
+        Actor actor = awake[i];
         if (auto *entity = actor.dyn_cast<Entity<N>>()) {
-            tick_entity(idled, Ref(entity));
+            if (has_history()) {
+                save_state(entity);
+            }
+            if (!fall(Ref(entity), i)) {
+                tick_entity(idled, Ref(entity));
+            }
+        }
+    }
+
+    {
+        profile_scope("world.sleep");
+        for (const Actor &actor : idled) {
+            sleep(actor);
+        }
+        // Islands resting on anything that moved or died this tick may no longer be supported
+        for (const Actor &actor : moved_) {
+            wake_dependents(actor);
+        }
+        for (const Actor &actor : died_) {
+            wake_dependents(actor);
+        }
+        moved_.clear();
+    }
+
+    {
+        profile_scope("world.remove");
+        profile_count("world.died", died_.size());
+        awake_.remove(died_.values());
+        for (const Actor &actor : died_) {
+            messages_.remove(actor); // Drop any messages sent to entities which died this tick
+        }
+        for (const Actor &actor : died_) {
+            contacts_.remove(actor);
+        }
+        for (const Actor &actor : died_) {
+            EntityIndex &tree = index(actor);
+            static_edits_ += (&tree == &static_) ? 1 : 0;
+            tree.remove(actor);
+            actors_.remove(actor.id());
+        }
+        died_.clear();
+    }
+    maybe_rebuild_static();
+    stream();
+    ++ticks_;
+    if (has_history()) {
+        begin_delta();
+    }
+}
+
+template <U64 N>
+void World<N>::integrate(const List<Actor> &entities) {
+    profile_scope("world.integrate");
+    const U64 n = entities.size();
+    free_fall_.candidate.assign(n, 0);
+    for (U64 d = 0; d < N; ++d) {
+        free_fall_.velocity[d].assign(n, 0);
+        free_fall_.accel[d].assign(n, 0);
+    }
+    U64 num_candidates = 0;
+    for (U64 i = 0; i < n; ++i) {
+        const Actor &actor = entities[i];
+        const auto *entity = actor.dyn_cast<Entity<N>>();
+        // Entities with messages or resting on something may not fall, and those starting to move notify those above
+        if (entity && entity->is_ballistic() && entity->velocity() != Pos<N>::zero && !messages_.has(actor) &&
+            !contacts_.has_below(actor)) {
+            free_fall_.candidate[i] = 1;
+            for (U64 d = 0; d < N; ++d) {
+                free_fall_.velocity[d][i] = entity->velocity()[d];
+                free_fall_.accel[d][i] = entity->accel()[d];
+            }
+            num_candidates += 1;
+        }
+    }
+    profile_count("world.falling", num_candidates);
+
+    // The same step as Entity::tick for an unsupported entity with nothing in its path
+    for (U64 d = 0; d < N; ++d) {
+        I64 *velocity = free_fall_.velocity[d].data();
+        I64 *accel = free_fall_.accel[d].data();
+        const I64 gravity = kGravity[d];
+        const I64 max_velocity = kMaxVelocity;
+        for (U64 i = 0; i < n; ++i) {
+            accel[i] += gravity;
+            velocity[i] = std::clamp(velocity[i] + accel[i], -max_velocity, max_velocity);
+        }
+    }
+}
+
+template <U64 N>
+bool World<N>::fall(Ref<Entity<N>> entity, const U64 i) {
+    return_if(!free_fall_.candidate[i], false);
+    const Actor actor = entity->self();
+    // Entities ticked earlier in this tick may have sent messages to this entity or come to rest on it
+    return_if(messages_.has(actor) || contacts_.has_below(actor), false);
+    Pos<N> velocity, accel;
+    for (U64 d = 0; d < N; ++d) {
+        velocity[d] = free_fall_.velocity[d][i];
+        accel[d] = free_fall_.accel[d][i];
+    }
+    return_if(velocity == Pos<N>::zero, false);
+
+    // With nothing else within a cell of its path, the entity can neither collide nor end up in contact with anything
+    const Box<N> prev_bbox = entity->bbox();
+    const Box<N> reach = bounding_box(prev_bbox, prev_bbox + velocity).widened(1);
+    return_if(!entities(reach).all([&](const Actor &other) { return other == actor; }), false);
+
+    entity->set_accel(accel);
+    entity->set_velocity(velocity);
+    entity->set_loc(entity->loc() + velocity);
+    index(actor).move(actor, prev_bbox);
+    moved_.insert(actor);
+    if (contacts_.has_above(actor)) {
+        update_contacts(entity.ptr());
+    }
+    if (entity->bbox().min[kVerticalDim] > kMaxY) {
+        send<Destroy>(nullptr, actor, Destroy::kOutOfBounds);
+    }
+    return true;
+}
+
+template <U64 N>
+List<Box<N>> World<N>::active_region() const {
+    List<Box<N>> region = interests_;
+    if (kActiveScreens > 0 && window_ != nullptr) {
+        const Box<2> view = window_to_world(window_->bbox());
+        const Pos<2> margin = view.shape() * static_cast<I64>(kActiveScreens);
+        // Unbounded in all dimensions other than those of the view
+        Box<N> box(Pos<N>::fill(std::numeric_limits<I64>::min() / 2), Pos<N>::fill(std::numeric_limits<I64>::max() / 2));
+        for (U64 i = 0; i < 2; ++i) {
+            box.min[i] = view.min[i] - margin[i];
+            box.max[i] = view.max[i] + margin[i];
         }
+        region.push_back(box);
+    }
+    return region;
+}
+
+template <U64 N>
+List<Actor> World<N>::active_entities() {
+    num_inactive_ = 0;
+    const bool reduced_tick = kInactivePeriod > 0 && ticks_ % kInactivePeriod == 0;
+    return_if(!has_active_region() || reduced_tick, List<Actor>(awake_.values()));
+
+    // Awake entities are usually far fewer than those in the region, so check each against the region directly
+    // rather than querying the region for (mostly sleeping) entities.
+    const List<Box<N>> region = active_region();
+    List<Actor> active;
+    for (const Actor &actor : awake_) {
+        const Box<N> bbox = actor.dyn_cast<Entity<N>>()->bbox();
+        if (region.range().exists([&](const Box<N> &box) { return box.overlaps(bbox); })) {
+            active.push_back(actor);
+        } else {
+            num_inactive_ += 1;
+        }
+    }
+    profile_count("world.inactive", num_inactive_);
+    return active;
+}
+
+template <U64 N>
+void World<N>::update_static(Ref<Entity<N>> entity, const Box<N> &prev_bbox) {
+    const Actor actor = entity->self();
+    static_edits_ += 1;
+    if (entity->falls()) {
+        std::unique_ptr<Entity<N>> released = static_.release(actor);
+        dynamic_.take(std::move(released));
+    } else {
+        static_.move(actor, prev_bbox);
+    }
+}
+
+template <U64 N>
+void World<N>::maybe_rebuild_static() {
+    return_if(static_edits_ <= std::max(kStaticRebuildMin, static_.size() / kStaticRebuildRatio));
+    profile_scope("world.rebuild_static");
+    static_.rebuild();
+    static_edits_ = 0;
+}
+
+template <U64 N>
+void World<N>::stream() {
+    return_if(!is_streaming());
+    profile_scope("world.stream");
+    insert_pages(/*wait=*/false);
+
+    const List<Box<N>> region = stream_region();
+    List<Pos<N>> nearby;
+    for (const auto &[chunk, _] : pages_) {
+        const Box<N> box = chunk_box(chunk);
+        if (region.range().exists([&](const Box<N> &b) { return b.overlaps(box); })) {
+            nearby.push_back(chunk);
+        }
+    }
+    for (const Pos<N> &chunk : nearby) {
+        load_chunk(chunk);
+    }
+
+    if (ticks_ % kEvictPeriod == 0) {
+        evict_chunks(region);
+    }
+    profile_count("world.paged", num_paged());
+}
+
+template <U64 N>
+List<Box<N>> World<N>::stream_region() const {
+    List<Box<N>> region = active_region();
+    for (Box<N> &box : region) {
+        box.min = box.min - kChunkSize;
+        box.max = box.max + kChunkSize;
+    }
+    return region;
+}
+
+template <U64 N>
+void World<N>::load_chunk(const Pos<N> &chunk) {
+    return_if(loading_.has(chunk)); // Pages written since the load started are loaded once it completes
+    List<std::string> paths = std::move(pages_[chunk]);
+    pages_.remove(chunk);
+    loading_[chunk] = std::async(std::launch::async, [paths = std::move(paths)] {
+        // Pages are only removed once their entities have been inserted
+        List<Page> pages;
+        for (const std::string &path : paths) {
+            std::ifstream is(path, std::ios::binary);
+            pages.emplace_back(path, std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>()));
+        }
+        return pages;
+    });
+}
+
+template <U64 N>
+void World<N>::insert_pages(const bool wait) {
+    List<Pos<N>> loaded;
+    List<std::pair<Pos<N>, std::string>> unread;
+    for (const auto &[chunk, future] : loading_) {
+        if (wait || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            for (const auto &[path, page] : future.get()) {
+                if (Snapshot<N>::read(*this, {page.data(), page.size()}).has_value()) {
+                    std::remove(path.c_str());
+                } else {
+                    if (!unreadable_.has(path)) {
+                        std::cerr << "Unable to read page " << path << " of chunk " << chunk << std::endl;
+                        unreadable_.insert(path);
+                    }
+                    unread.push_back({chunk, path});
+                }
+            }
+            loaded.push_back(chunk);
+        }
+    }
+    for (const Pos<N> &chunk : loaded) {
+        loading_.remove(chunk);
+    }
+    for (const auto &[chunk, path] : unread) {
+        pages_[chunk].push_back(path);
+    }
+}
+
+template <U64 N>
+void World<N>::evict_chunks(const List<Box<N>> &region) {
+    Map<Pos<N>, List<Actor>> chunks;
+    for (const Actor &actor : actors_) {
+        chunks[chunk(actor.dyn_cast<Entity<N>>()->bbox())].push_back(actor);
+    }
+    return_if(chunks.size() <= kResidentChunks);
+
+    // A chunk can only be evicted if none of its entities are within the region (e.g. terrain which extends into it)
+    // or have pending or scheduled messages, which would otherwise be lost.
+    List<std::pair<I64, Pos<N>>> candidates;
+    for (const auto &[chunk, actors] : chunks) {
+        const bool needed = actors.range().exists([&](const Actor &actor) {
+            const Box<N> bbox = actor.dyn_cast<Entity<N>>()->bbox();
+            return messages_.has(actor) || num_timers_.has(actor) ||
+                   region.range().exists([&](const Box<N> &box) { return box.overlaps(bbox); });
+        });
+        if (!needed) {
+            const Box<N> box = chunk_box(chunk);
+            I64 dist = std::numeric_limits<I64>::max();
+            for (const Box<N> &b : region) {
+                dist = std::min(dist, box.manhattan_dist(b));
+            }
+            candidates.push_back({dist, chunk});
+        }
+    }
+
+    // Evict the most distant chunks first
+    std::vector<std::pair<I64, Pos<N>>> order(candidates.begin(), candidates.end());
+    std::sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+    const U64 excess = chunks.size() - kResidentChunks;
+    for (U64 i = 0; i < std::min<U64>(excess, order.size()); ++i) {
+        evict_chunk(order[i].second, chunks.at(order[i].second));
+    }
+}
+
+template <U64 N>
+bool World<N>::make_page_dir() {
+    return_if(!page_path_.empty(), true);
+    std::error_code error;
+    const std::filesystem::path dir =
+        kPageDir.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path(kPageDir);
+    std::string path = (dir / "nvl-pages-XXXXXX").string();
+    if (error || ::mkdtemp(path.data()) == nullptr) {
+        std::cerr << "Unable to make a directory for pages in " << dir << std::endl;
+        return false;
+    }
+    page_path_ = path;
+    return true;
+}
+
+template <U64 N>
+void World<N>::evict_chunk(const Pos<N> &chunk, const List<Actor> &actors) {
+    return_if(!make_page_dir());
+    std::string path = page_path_ + "/chunk";
+    for (U64 i = 0; i < N; ++i) {
+        path += "_" + std::to_string(chunk[i]);
+    }
+    path += "." + std::to_string(next_page_++) + ".nvls";
+    if (!Snapshot<N>::save(actors.range(), path)) {
+        std::cerr << "Unable to write page " << path << ", keeping chunk " << chunk << " in memory" << std::endl;
+        std::remove(path.c_str());
+        return;
+    }
+    pages_[chunk].push_back(path);
+    for (const Actor &actor : actors) {
+        evict(actor);
+    }
+}
+
+template <U64 N>
+void World<N>::evict(const Actor &actor) {
+    wake(actor); // Detaches the entity from anything it rests on
+    awake_.remove(actor);
+    dependents_.remove(actor);
+    contacts_.remove(actor);
+    EntityIndex &tree = index(actor);
+    static_edits_ += (&tree == &static_) ? 1 : 0;
+    tree.remove(actor);
+    actors_.remove(actor.id());
+}
+
+template <U64 N>
+void World<N>::relink_dependents(const Entity<N> *entity) {
+    const Actor actor = entity->self();
+    for (const Actor &above : entity->above()) {
+        if (Set<Actor> *supports = supports_.get(above)) {
+            List<Actor> evicted;
+            for (const Actor &support : *supports) {
+                if (!has(support)) {
+                    evicted.push_back(support);
+                }
+            }
+            supports->remove(evicted.range());
+            supports->insert(actor);
+            dependents_[actor].insert(above);
+        }
+    }
+}
+
+template <U64 N>
+void World<N>::begin_delta() {
+    Delta &next = delta();
+    next.tick = ticks_;
+    next.changed.clear();
+    next.spawned.clear();
+    next.messages = messages_;
+    next.scheduled.clear();
+    next.fired.clear();
+}
+
+template <U64 N>
+void World<N>::save_state(const Entity<N> *entity) {
+    EntityState state = {.actor = entity->self(),
+                         .loc = entity->loc(),
+                         .velocity = entity->velocity(),
+                         .accel = entity->accel()};
+    if (messages_.has(state.actor)) {
+        List<Part<N>> parts;
+        for (const Ref<Part<N>> &part : entity->relative.parts()) {
+            parts.push_back(part.raw());
+        }
+        state.parts = std::move(parts);
+    }
+    delta().changed.push_back(std::move(state));
+}
+
+template <U64 N>
+bool World<N>::can_restore(const U64 tick) const {
+    return_if(!has_history() || tick > ticks_ || ticks_ - tick >= kHistory, false);
+    for (U64 t = tick; t <= ticks_; ++t) {
+        return_if(history_[t % kHistory].tick != t, false);
+    }
+    return true;
+}
+
+template <U64 N>
+bool World<N>::restore(const U64 tick) {
+    return_if(!can_restore(tick), false);
+    profile_scope("world.restore");
+
+    // Entities which died are recreated with new handles, so older deltas refer to them by their original handles
+    Map<Actor, Actor> recreated;
+    const auto current = [&](const Actor &actor) {
+        const Actor *replacement = recreated.get(actor);
+        return replacement ? *replacement : actor;
+    };
+
+    Set<Actor> touched;
+    for (U64 t = ticks_ + 1; t-- > tick;) {
+        const Delta &undo = history_[t % kHistory];
+        // Recreating entities inserts them into the current delta, so take the entities to remove first
+        const List<Actor> spawned = undo.spawned;
+        for (U64 i = undo.changed.size(); i-- > 0;) {
+            const EntityState &state = undo.changed[i];
+            Actor actor = current(state.actor);
+            if (has(actor)) {
+                auto *entity = actor.dyn_cast<Entity<N>>();
+                const Box<N> prev_bbox = entity->bbox();
+                entity->set_loc(state.loc);
+                entity->set_velocity(state.velocity);
+                entity->set_accel(state.accel);
+                if (state.parts.has_value()) {
+                    entity->set_parts(*state.parts);
+                }
+                index(actor).move(actor, prev_bbox);
+                touched.insert(actor);
+            } else if (state.parts.has_value()) {
+                List<Part<N>> parts = *state.parts;
+                List<Ref<Part<N>>> refs;
+                for (Part<N> &part : parts) {
+                    refs.emplace_back(part);
+                }
+                auto block = std::make_unique<Block<N>>(state.loc, refs.range());
+                block->set_velocity(state.velocity);
+                block->set_accel(state.accel);
+                const Actor replacement = insert(std::move(block));
+                recreated[state.actor] = replacement;
+                touched.insert(replacement);
+            }
+        }
+        for (const Actor &added : spawned) {
+            const Actor actor = current(added);
+            if (has(actor)) {
+                wake_dependents(actor);
+                evict(actor);
+                touched.remove(actor);
+            }
+        }
+    }
+
+    messages_.clear();
+    for (const auto &[actor, messages] : history_[tick % kHistory].messages) {
+        if (const Actor dst = current(actor); has(dst)) {
+            messages_[dst] = messages;
+        }
+    }
+
+    // Scheduled messages which became due since are pending again, and those scheduled since are discarded
+    Set<U64> discarded;
+    List<Timer> timers = timers_.drain(tick);
+    for (U64 t = tick; t <= ticks_; ++t) {
+        const Delta &undo = history_[t % kHistory];
+        discarded.insert(undo.scheduled.range());
+        for (const Timer &timer : undo.fired) {
+            timers.push_back(timer);
+        }
+    }
+    timers.sort([](const Timer &a, const Timer &b) { return a.id < b.id; });
+    num_timers_.clear();
+    for (Timer &timer : timers) {
+        if (!discarded.has(timer.id)) {
+            timer.value.first = current(timer.value.first);
+            num_timers_[timer.value.first] += 1;
+            timers_.schedule(std::move(timer));
+        }
+    }
+    for (const Actor &actor : touched) {
+        update_contacts(actor.dyn_cast<Entity<N>>());
+    }
+    for (const Actor &actor : touched) {
+        wake(actor);
+        wake_dependents(actor);
     }
-    awake_.remove(died_.values());
-    awake_.remove(idled.values());
-    entities_.remove(died_.values());
     died_.clear();
+    moved_.clear();
+    ticks_ = tick;
+    begin_delta();
+    return true;
+}
+
+template <U64 N>
+void World<N>::update_contacts(const Entity<N> *entity) {
+    profile_scope("world.contacts");
+    const Actor &actor = entity->self();
+    // Contacts are only found within a cell above or below the entity, so an entity without contacts which has nothing
+    // else there still has none (e.g. while falling beside something)
+    if (!contacts_.has_above(actor) && !contacts_.has_below(actor)) {
+        const Box<N> bbox = entity->bbox();
+        const Box<N> reach = bbox.with(kVerticalDim, bbox.min[kVerticalDim] - 1, bbox.max[kVerticalDim] + 1);
+        return_if(entities(reach).all([&](const Actor &other) { return other == actor; }));
+    }
+    auto [above, below] = entity->find_contacts();
+    contacts_.update(actor, std::move(above), std::move(below));
+}
+
+template <U64 N>
+void World<N>::sleep(const Actor &actor) {
+    const auto *entity = actor.dyn_cast<Entity<N>>();
+    Set<Actor> supports = entity->below();
+    // Entities which are unsupported (e.g. if their support moved away this tick) stay awake to start falling
+    return_if(entity->falls() && supports.empty());
+    for (const Actor &support : supports) {
+        dependents_[support].insert(actor);
+    }
+    supports_[actor] = std::move(supports);
+    awake_.remove(actor);
+}
+
+template <U64 N>
+void World<N>::wake(const Actor &actor) {
+    awake_.insert(actor);
+    if (const Set<Actor> *supports = supports_.get(actor)) {
+        for (const Actor &support : *supports) {
+            if (Set<Actor> *dependents = dependents_.get(support)) {
+                dependents->remove(actor);
+                if (dependents->empty()) {
+                    dependents_.remove(support);
+                }
+            }
+        }
+        supports_.remove(actor);
+    }
+}
+
+template <U64 N>
+void World<N>::wake_dependents(const Actor &actor) {
+    List<Actor> worklist{actor};
+    while (!worklist.empty()) {
+        const Actor current = worklist.back();
+        worklist.pop_back();
+        if (const Set<Actor> *dependents = dependents_.get(current)) {
+            const List<Actor> woken(dependents->values());
+            dependents_.remove(current);
+            for (const Actor &dependent : woken) {
+                wake(dependent);
+                worklist.push_back(dependent);
+            }
+        }
+    }
 }
 
 template <U64 N>
@@ -177,8 +1126,10 @@ void World<N>::draw() {
     const Box<2> range = window_to_world(window_->bbox());
     {
         const auto offset = Window::Offset(window_, view_);
-        for (const Actor &actor : entities(range)) {
-            actor->draw(window_, {});
+        if constexpr (N == 2) {
+            for (const Actor &actor : entities(range)) {
+                actor->draw(window_, {});
+            }
         }
     }
 
@@ -195,26 +1146,68 @@ void World<N>::draw() {
     window_->text(Color::kBlack, {10, 40}, 20, range.to_string());
     window_->text(Color::kBlack, {10, 70}, 20, "Alive: " + std::to_string(num_alive()));
     window_->text(Color::kBlack, {10, 100}, 20, "Awake: " + std::to_string(num_awake()));
+    window_->text(Color::kBlack, {10, 130}, 20, "Asleep: " + std::to_string(num_asleep()));
+    window_->text(Color::kBlack, {10, 160}, 20, "Inactive: " + std::to_string(num_inactive()));
+    window_->text(Color::kBlack, {10, 190}, 20, "Paged: " + std::to_string(num_paged()));
+
+    if constexpr (Profiler::kEnabled) {
+        if (hud_) {
+            draw_profile(220);
+        }
+    }
 }
 
+/// Draws one line per profiled metric with its rolling mean, p99, and max starting at `y`.
 template <U64 N>
-void World<N>::tick_entity(Set<Actor> &idled, Ref<Entity<N>> entity) {
-    static const List<Message> kNoMessages = {};
+void World<N>::draw_profile(I64 y) const {
+    const Profiler &profiler = Profiler::global();
+    for (Profiler::Id id = 0; id < profiler.metrics().size(); ++id) {
+        const Profiler::Metric &metric = profiler.metric(id);
+        const Profiler::Summary summary = profiler.summary(id);
+        std::string line = metric.name + ": ";
+        if (metric.kind == Profiler::Kind::kTimer) {
+            line += Duration(summary.mean).to_string() + " (p99 " + Duration(summary.p99).to_string() + ", max " +
+                    Duration(summary.max).to_string() + ")";
+        } else {
+            line += std::to_string(summary.mean) + " (p99 " + std::to_string(summary.p99) + ", max " +
+                    std::to_string(summary.max) + ")";
+        }
+        window_->text(Color::kBlack, {10, y}, 16, line);
+        y += 20;
+    }
+}
 
+template <U64 N>
+void World<N>::tick_entity(Set<Actor> &idled, Ref<Entity<N>> entity) {
     const Actor actor = entity->self();
     const Box<N> prev_bbox = entity->bbox();
-    const auto messages_iter = messages_.find(actor);
-    const List<Message> &messages = messages_iter == messages_.end() ? kNoMessages : messages_iter->second;
+
+    // Take ownership of the pending messages, as ticking may send new messages
+    List<Message> messages;
+    if (List<Message> *pending = messages_.get(actor)) {
+        messages = std::move(*pending);
+        messages_.remove(actor);
+    }
+    profile_count("world.messages", messages.size());
     const Status status = entity->tick(messages);
     if (status == Status::kDied) {
         died_.insert(actor);
     } else if (status == Status::kIdle) {
         idled.insert(actor);
     } else if (status == Status::kMove) {
-        entities_.move(actor, prev_bbox);
+        profile_scope("world.move");
+        index(actor).move(actor, prev_bbox);
+        moved_.insert(actor);
+    }
+
+    // Contacts only change when the entity moves or changes shape; contacts of entities which were not updated are
+    // kept consistent since each update also replaces the reverse side of the updated entity's contacts.
+    const bool was_hit = messages.range().exists([](const Message &message) { return message.isa<Hit<N>>(); });
+    if (status != Status::kDied && (status == Status::kMove || was_hit)) {
+        update_contacts(entity.ptr());
     }
-    if (messages_iter != messages_.end()) {
-        messages_.erase(messages_iter);
+    if (status != Status::kDied && was_hit && static_.has(actor)) {
+        update_static(entity, prev_bbox);
     }
 
     // Check if the entity is now above the maximum Y limits (down is positive)
@@ -224,3 +1217,6 @@ void World<N>::tick_entity(Set<Actor> &idled, Ref<Entity<N>> entity) {
 }
 
 } // namespace nvl
+
+// Snapshot refers to World, so is included once World is defined
+#include "nvl/world/Snapshot.h"
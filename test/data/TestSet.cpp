@@ -0,0 +1,20 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "nvl/data/Set.h"
+
+namespace {
+
+using testing::UnorderedElementsAre;
+
+using nvl::Set;
+
+TEST(TestSet, copy_assign) {
+    const Set<U64> a{1, 2, 3};
+    Set<U64> b{4};
+    b = a;
+    EXPECT_THAT(b.values(), UnorderedElementsAre(1, 2, 3));
+    EXPECT_EQ(a, b);
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "nvl/data/SlotMap.h"
+#include "nvl/data/SlotSet.h"
+
+namespace {
+
+using testing::UnorderedElementsAre;
+
+using nvl::List;
+using nvl::SlotId;
+using nvl::SlotMap;
+using nvl::SlotSet;
+
+TEST(TestSlotMap, insert_remove) {
+    SlotMap<std::string> map;
+    const SlotId a = map.insert("a");
+    const SlotId b = map.insert("b");
+    const SlotId c = map.insert("c");
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(*map.get(b), "b");
+
+    EXPECT_TRUE(map.remove(a));
+    EXPECT_FALSE(map.remove(a));
+    EXPECT_FALSE(map.has(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(*map.get(b), "b");
+    EXPECT_EQ(*map.get(c), "c"); // Moved into the removed value's place
+    EXPECT_THAT(List<std::string>(map.values()), UnorderedElementsAre("b", "c"));
+
+    // The freed slot is reused with a new generation, so the old id stays stale
+    const SlotId d = map.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d, a);
+    EXPECT_FALSE(map.has(a));
+    EXPECT_EQ(*map.get(d), "d");
+    for (U64 i = 0; i < map.size(); ++i) {
+        EXPECT_EQ(*map.get(map.id_at(i)), List<std::string>(map.values())[i]);
+    }
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.has(b));
+    EXPECT_FALSE(map.has(SlotId()));
+}
+
+struct Value {
+    pure SlotId id() const { return id_; }
+    pure bool operator==(const Value &rhs) const { return id_ == rhs.id_; }
+    SlotId id_;
+};
+
+TEST(TestSlotMap, slot_set) {
+    SlotSet<Value> set;
+    const Value a{{0, 0}}, b{{5, 1}}, c{{2, 0}};
+    EXPECT_TRUE(set.insert(a));
+    EXPECT_TRUE(set.insert(b));
+    EXPECT_TRUE(set.insert(c));
+    EXPECT_FALSE(set.insert(b));
+    EXPECT_EQ(set.size(), 3);
+    EXPECT_TRUE(set.has(b));
+    EXPECT_FALSE(set.has(SlotId{5, 0})); // Same slot but a different generation
+
+    EXPECT_TRUE(set.remove(a));
+    EXPECT_FALSE(set.remove(a));
+    EXPECT_FALSE(set.has(a));
+    EXPECT_TRUE(set.has(b));
+    EXPECT_TRUE(set.has(c));
+    EXPECT_EQ(set.size(), 2);
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.has(c));
+}
+
+} // namespace
@@ -0,0 +1,76 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "nvl/data/StaticList.h"
+
+namespace {
+
+using testing::ElementsAre;
+
+using nvl::StaticList;
+
+TEST(TestStaticList, push_and_pop) {
+    StaticList<std::string, 3> list;
+    EXPECT_TRUE(list.empty());
+    list.push_back("a");
+    list.emplace_back(2, 'b');
+    EXPECT_EQ(list.size(), 2);
+    EXPECT_EQ(list.front(), "a");
+    EXPECT_EQ(list.back(), "bb");
+    EXPECT_THAT(list, ElementsAre("a", "bb"));
+
+    list.push_back("c");
+    EXPECT_DEATH({ list.push_back("d"); }, "StaticList is full with capacity 3");
+    EXPECT_DEATH({ std::cout << list[3]; }, "out of bounds \\[0, 3\\)");
+
+    list.pop_back();
+    EXPECT_THAT(list, ElementsAre("a", "bb"));
+    const StaticList<std::string, 3> same{"a", "bb"};
+    const StaticList<std::string, 3> other{"a"};
+    EXPECT_EQ(list, same);
+    EXPECT_NE(list, other);
+    list.clear();
+    EXPECT_TRUE(list.empty());
+}
+
+struct Counted {
+    explicit Counted(I64 *alive) : alive(alive) { *alive += 1; }
+    Counted(const Counted &rhs) : alive(rhs.alive) { *alive += 1; }
+    ~Counted() { *alive -= 1; }
+    I64 *alive;
+};
+
+TEST(TestStaticList, constructs_only_added_values) {
+    I64 alive = 0;
+    {
+        StaticList<Counted, 4> list;
+        EXPECT_EQ(alive, 0);
+        list.emplace_back(&alive);
+        list.emplace_back(&alive);
+        EXPECT_EQ(alive, 2);
+        const StaticList<Counted, 4> copy = list;
+        EXPECT_EQ(alive, 4);
+        list.pop_back();
+        EXPECT_EQ(alive, 3);
+    }
+    EXPECT_EQ(alive, 0);
+}
+
+constexpr StaticList<I64, 4> squares(const I64 n) {
+    StaticList<I64, 4> result;
+    for (I64 i = 1; i <= n; ++i) {
+        result.push_back(i * i);
+    }
+    return result;
+}
+
+TEST(TestStaticList, constexpr_list) {
+    static_assert(squares(3).size() == 3);
+    static_assert(squares(4).back() == 16);
+    static_assert(squares(2) == StaticList<I64, 4>({1, 4}));
+    static_assert(StaticList<I64, 4>::capacity() == 4);
+}
+
+} // namespace
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "nvl/data/TimerWheel.h"
+
+namespace {
+
+using nvl::List;
+using nvl::TimerWheel;
+
+TEST(TestTimerWheel, schedule) {
+    TimerWheel<U64> wheel;
+    wheel.schedule(0, 1); // Due on the next tick
+    wheel.schedule(1, 1);
+    wheel.schedule(3, 3);
+    wheel.schedule(3, 4);
+    EXPECT_EQ(wheel.size(), 4);
+    EXPECT_EQ(wheel.advance(), List<U64>({1, 1}));
+    EXPECT_TRUE(wheel.advance().empty());
+    EXPECT_EQ(wheel.advance(), List<U64>({3, 4})); // In the order they were scheduled
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.now(), 3);
+}
+
+/// Checks that values scheduled with each of the given delays are due exactly that many ticks later.
+template <U64 kLevels>
+void expect_due(const List<U64> &delays) {
+    TimerWheel<U64, kLevels> wheel;
+    for (U64 i = 0; i < 1000; ++i) {
+        wheel.advance(); // Start from a time which is not aligned to any level
+    }
+    const U64 start = wheel.now();
+    for (const U64 delay : delays) {
+        wheel.schedule(delay, start + delay);
+    }
+    U64 fired = 0;
+    while (!wheel.empty()) {
+        for (const U64 due : wheel.advance()) {
+            EXPECT_EQ(due, wheel.now());
+            fired += 1;
+        }
+    }
+    EXPECT_EQ(fired, delays.size());
+}
+
+TEST(TestTimerWheel, levels) {
+    // Delays across every level boundary
+    constexpr U64 kSlots = TimerWheel<U64>::kSlots;
+    expect_due<4>({1, kSlots - 1, kSlots, kSlots + 1, kSlots * kSlots - 1, kSlots * kSlots, kSlots * kSlots * 5 + 7,
+                   kSlots * kSlots * kSlots + 3});
+    // Delays beyond the range of the top level
+    expect_due<2>({kSlots * kSlots - 1, kSlots * kSlots, kSlots * kSlots + 5, kSlots * kSlots * 3 + 1});
+}
+
+TEST(TestTimerWheel, drain) {
+    TimerWheel<U64> wheel;
+    const U64 a = wheel.schedule(2, 1);
+    wheel.schedule(TimerWheel<U64>::kSlots + 3, 2);
+    const U64 c = wheel.schedule(3, 3);
+    EXPECT_NE(a, c);
+    wheel.advance();
+    auto fired = wheel.expire();
+    ASSERT_EQ(fired.size(), 1);
+    EXPECT_EQ(fired[0].id, a);
+    EXPECT_EQ(fired[0].due, 2);
+
+    // Rewind to tick 1, scheduling the fired value again and discarding the last one
+    auto entries = wheel.drain(1);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.now(), 1);
+    ASSERT_EQ(entries.size(), 2);
+    entries.push_back(fired[0]);
+    for (auto &entry : entries) {
+        if (entry.id != c) {
+            wheel.schedule(std::move(entry));
+        }
+    }
+    EXPECT_EQ(wheel.size(), 2);
+    EXPECT_EQ(wheel.advance(), List<U64>({1}));
+    EXPECT_TRUE(wheel.advance().empty());
+    while (wheel.now() + 1 < TimerWheel<U64>::kSlots + 3) {
+        EXPECT_TRUE(wheel.advance().empty());
+    }
+    EXPECT_EQ(wheel.advance(), List<U64>({2}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+} // namespace
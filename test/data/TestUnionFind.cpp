@@ -19,4 +19,13 @@ TEST(TestUnionFind, basic) {
     EXPECT_THAT(sets.sets(), UnorderedElementsAre(Set<U64>{0, 1, 2}, Set<U64>{4, 5}, Set<U64>{6, 7}));
 }
 
+TEST(TestUnionFind, merge_groups) {
+    UnionFind<U64> sets;
+    sets.add(0, 1);
+    sets.add(2, 3);
+    sets.add(1, 3); // Merges the first group into the second
+    sets.add(0, 4); // 0 must now be found in the merged group
+    EXPECT_THAT(sets.sets(), UnorderedElementsAre(Set<U64>{0, 1, 2, 3, 4}));
+}
+
 } // namespace
\ No newline at end of file
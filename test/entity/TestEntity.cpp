@@ -1,13 +1,18 @@
 #include <gtest/gtest.h>
 
 #include "nvl/entity/Entity.h"
+#include "nvl/material/TestMaterial.h"
 
 namespace {
 
+using nvl::Box;
 using nvl::Color;
 using nvl::Entity;
+using nvl::Material;
+using nvl::Part;
 using nvl::Pos;
 using nvl::Status;
+using nvl::TestMaterial;
 using nvl::Window;
 
 struct SimpleEntity : Entity<2> {
@@ -21,4 +26,30 @@ TEST(TestEntity, construct) {
     entity.tick({});
 }
 
+TEST(TestEntity, compact_parts) {
+    static_assert(sizeof(Part<2, I32>) < sizeof(Part<2>));
+    EXPECT_TRUE((Part<2, I32>::fits(Box<2>({-3, 0}, {9, 6}))));
+    EXPECT_FALSE((Part<2, I32>::fits(Box<2>({0, 0}, {9, I64(1) << 40}))));
+    EXPECT_TRUE(Part<2>::fits(Box<2>({0, 0}, {9, I64(1) << 40})));
+
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    SimpleEntity entity(Pos<2>(I64(1) << 40, -5), {});
+    entity.set_parts({Part<2>(Box<2>({0, 0}, {9, 4}), material), Part<2>(Box<2>({-3, 5}, {2, 6}), material)});
+    EXPECT_EQ(entity.bbox(), Box<2>({-3, 0}, {9, 6}) + entity.loc());
+    const nvl::List<nvl::At<2, Part<2>>> hit(entity.parts(entity.loc()));
+    ASSERT_EQ(hit.size(), 1);
+    EXPECT_EQ(hit[0].bbox(), Box<2>({0, 0}, {9, 4}) + entity.loc());
+    EXPECT_TRUE(entity.parts(entity.loc() + Pos<2>(10, 0)).empty());
+}
+
+TEST(TestEntity, absolute_parts) {
+    // Entities are usually spawned at the origin, with parts at absolute coordinates
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Box<2> box({I64(1) << 40, -5}, {(I64(1) << 40) + 9, 4});
+    SimpleEntity entity(Pos<2>::zero, {});
+    entity.set_parts({Part<2>(box, material)});
+    EXPECT_EQ(entity.bbox(), box);
+    EXPECT_EQ((nvl::List<nvl::At<2, Part<2>>>(entity.parts(box.min)).size()), 1);
+}
+
 } // namespace
@@ -60,7 +60,8 @@ TEST(TestBRTree, move) {
 TEST(TestBRTree, edges) {
     BRTree<2, LabeledBox> tree;
     const auto box = tree.emplace(1, Box<2>({0, 0}, {32, 32}));
-    List<Edge<2>> edges = box->bbox().edges();
+    const auto sides = box->bbox().edges();
+    List<Edge<2>> edges(sides.begin(), sides.end());
 
     EXPECT_EQ(tree.edge_rtree().size(), 4);
 
@@ -32,6 +32,7 @@ using testing::ElementsAre;
 using testing::UnorderedElementsAre;
 
 using nvl::Box;
+using nvl::Box32;
 using nvl::Dir;
 using nvl::Edge;
 using nvl::List;
@@ -185,11 +186,40 @@ TEST(TestBox, diff) {
                                                         Box<2>({2, 12}, {6, 14}), Box<2>({2, 3}, {6, 6})));
 }
 
+TEST(TestBox, constexpr_geometry) {
+    constexpr Box<2> box({0, 0}, {7, 7});
+    static_assert(box.diff(Box<2>({2, 2}, {3, 3})).size() == 4);
+    static_assert(box.diff(Box<2>({-2, -2}, {9, 9})).empty());
+    static_assert(box.diff(Box<2>({8, 0}, {9, 9})).front() == box);
+    static_assert(box.edges().size() == 4);
+    static_assert(box.edges()[0] == Edge<2>(0, Dir::Pos, Box<2>({8, 0}, {8, 7})));
+}
+
 TEST(TestBox, to_string) {
     constexpr Box<2> a({2, 3}, {7, 8});
     EXPECT_EQ(a.to_string(), "{2, 3}::{7, 8}");
 }
 
+TEST(TestBox, compact) {
+    static_assert(sizeof(Box32<2>) == sizeof(Box<2>) / 2);
+
+    constexpr Box32<2> a({2, 3}, {7, 8});
+    const Box<2> b = a;
+    EXPECT_EQ(b, Box<2>({2, 3}, {7, 8}));
+    EXPECT_EQ(Box32<2>(b), a);
+    EXPECT_EQ(a + 1, Box32<2>({3, 4}, {8, 9}));
+    EXPECT_TRUE(a.overlaps(Box32<2>({7, 8}, {9, 9})));
+    EXPECT_THAT(a.diff(Box32<2>({4, 0}, {9, 9})), UnorderedElementsAre(Box32<2>({2, 3}, {3, 8})));
+}
+
+TEST(TestBox, compact_overflow) {
+#ifdef NDEBUG
+    GTEST_SKIP() << "Narrowing conversions are only checked in debug builds";
+#else
+    EXPECT_DEATH({ std::cout << Box32<2>(Box<2>({0, 0}, {0, I64(1) << 40})); }, "overflows 32-bit coordinates");
+#endif
+}
+
 /// Generic fuzz testing across N dimensional diffing
 template <U64 N>
 struct FuzzBoxDiff : nvl::test::FuzzingTestFixture<List<Box<N>>, Box<N>, Box<N>> {
@@ -201,7 +231,10 @@ struct FuzzBoxDiff : nvl::test::FuzzingTestFixture<List<Box<N>>, Box<N>, Box<N>>
         this->in[0] = Distribution::Uniform<I64>(1, 15);
         this->in[1] = Distribution::Uniform<I64>(1, 15);
 
-        this->fuzz([](List<Box<N>> &diff, const Box<N> &a, const Box<N> &b) { diff = a.diff(b); });
+        this->fuzz([](List<Box<N>> &diff, const Box<N> &a, const Box<N> &b) {
+            const auto result = a.diff(b);
+            diff = List<Box<N>>(result.begin(), result.end());
+        });
 
         this->verify([&](const List<Box<N>> &diff, const Box<N> &a, const Box<N> &b) {
             // Confirm that we get no more than 2*N boxes
@@ -0,0 +1,69 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "nvl/data/List.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/BoxArray.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+using nvl::Box;
+using nvl::BoxArray;
+using nvl::List;
+using nvl::Pos;
+
+TEST(TestBoxArray, overlap_mask) {
+    const List<Box<2>> boxes{Box<2>({0, 0}, {3, 3}), Box<2>({4, 4}, {5, 5}), Box<2>({-2, 1}, {0, 1}),
+                             Box<2>({3, -1}, {3, 9}), Box<2>({6, 0}, {9, 0})};
+    BoxArray<2> array;
+    for (const Box<2> &box : boxes) {
+        array.push_back(box);
+    }
+    EXPECT_EQ(array.size(), 5);
+    EXPECT_EQ(array[3], boxes[3]);
+
+    const Box<2> query({0, 1}, {3, 4});
+    EXPECT_EQ(array.overlap_mask(query), 0b01101);
+    EXPECT_EQ(nvl::overlap_mask(query, &boxes[0], boxes.size()), 0b01101);
+    EXPECT_EQ(array.overlap_mask(query, 2), 0b011);
+    EXPECT_THAT(array.intersect_all(query),
+                ElementsAre(Box<2>({0, 1}, {3, 3}), Box<2>({0, 1}, {0, 1}), Box<2>({3, 1}, {3, 4})));
+}
+
+template <U64 N>
+void expect_matches_boxes() {
+    nvl::Random random(0xDEADBEEF);
+    List<Box<N>> boxes;
+    BoxArray<N> array;
+    for (U64 i = 0; i < 300; ++i) {
+        const auto min = random.uniform<Pos<N>, I64>(-100, 100);
+        boxes.emplace_back(min, min + random.uniform<Pos<N>, I64>(0, 20));
+        array.push_back(boxes.back());
+    }
+    for (U64 q = 0; q < 100; ++q) {
+        const Box<N> query(random.uniform<Pos<N>, I64>(-100, 100), random.uniform<Pos<N>, I64>(-100, 100));
+        List<U64> expected, actual;
+        List<Box<N>> intersections;
+        for (U64 i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].overlaps(query)) {
+                expected.push_back(i);
+                intersections.push_back(boxes[i].intersect(query).value());
+            }
+        }
+        array.overlapping(query, [&](const U64 i) { actual.push_back(i); });
+        EXPECT_THAT(actual, ElementsAreArray(expected)) << query;
+        EXPECT_THAT(array.intersect_all(query), ElementsAreArray(intersections)) << query;
+    }
+}
+
+TEST(TestBoxArray, matches_boxes) {
+    expect_matches_boxes<2>();
+    expect_matches_boxes<3>();
+}
+
+} // namespace
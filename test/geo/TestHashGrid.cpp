@@ -0,0 +1,133 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Set.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/HashGrid.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/geo/RTree.h"
+#include "nvl/geo/SpatialIndex.h"
+#include "nvl/math/Random.h"
+#include "nvl/test/LabeledBox.h"
+
+namespace {
+
+using testing::IsEmpty;
+using testing::UnorderedElementsAre;
+
+using nvl::AnyIndex;
+using nvl::Box;
+using nvl::HashGrid;
+using nvl::List;
+using nvl::Pos;
+using nvl::Ref;
+using nvl::RTree;
+using nvl::Set;
+using nvl::test::LabeledBox;
+
+using Grid = HashGrid<2, LabeledBox, Ref<LabeledBox>, /*cell_exp*/ 3>;
+using Tree = RTree<2, LabeledBox>;
+
+static_assert(nvl::SpatialIndex<Grid, 2, LabeledBox, Ref<LabeledBox>>);
+static_assert(nvl::SpatialIndex<Tree, 2, LabeledBox, Ref<LabeledBox>>);
+
+/// Returns the ids of the items in `index` overlapping `box`.
+template <typename Index>
+Set<U64> ids_in(const Index &index, const Box<2> &box) {
+    Set<U64> ids;
+    for (const Ref<LabeledBox> &item : index[box]) {
+        EXPECT_FALSE(ids.has(item->id())) << "Item " << item->id() << " reported twice";
+        ids.insert(item->id());
+    }
+    return ids;
+}
+
+/// Returns the ids of the given items overlapping `box`, found by checking every item.
+Set<U64> brute_force_ids(const List<LabeledBox> &items, const Box<2> &box) {
+    Set<U64> ids;
+    for (const LabeledBox &item : items) {
+        if (item.bbox().overlaps(box)) {
+            ids.insert(item.id());
+        }
+    }
+    return ids;
+}
+
+TEST(TestHashGrid, insert_and_query) {
+    Grid grid;
+    const Ref<LabeledBox> a = grid.emplace(0, Box<2>({0, 0}, {3, 3}));
+    const Ref<LabeledBox> b = grid.emplace(1, Box<2>({-20, 5}, {20, 6})); // Spans several cells
+    EXPECT_EQ(grid.size(), 2);
+    EXPECT_EQ(grid.num_cells(), 6);
+    EXPECT_THAT(List<Ref<LabeledBox>>(grid[Pos<2>(1, 1)]), UnorderedElementsAre(a));
+    EXPECT_THAT(List<Ref<LabeledBox>>(grid[Box<2>({-100, -100}, {100, 100})]), UnorderedElementsAre(a, b));
+    EXPECT_THAT(List<Ref<LabeledBox>>(grid[Pos<2>(10, 10)]), IsEmpty());
+    EXPECT_THAT(List<Ref<LabeledBox>>(grid.items()), UnorderedElementsAre(a, b));
+
+    std::unique_ptr<LabeledBox> released = grid.release(b);
+    EXPECT_EQ(released->id(), 1);
+    EXPECT_FALSE(grid.has(b));
+    EXPECT_EQ(grid.num_cells(), 1);
+    EXPECT_EQ(grid.release(b), nullptr);
+}
+
+TEST(TestHashGrid, matches_brute_force) {
+    nvl::Random random(0xDEADBEEF);
+    Grid grid;
+    List<LabeledBox> boxes;
+    List<Ref<LabeledBox>> refs;
+    for (U64 i = 0; i < 300; ++i) {
+        const auto min = random.uniform<Pos<2>, I64>(-200, 200);
+        boxes.emplace_back(i, Box<2>(min, min + random.uniform<Pos<2>, I64>(0, 30)));
+        refs.push_back(grid.insert(boxes.back()));
+    }
+    const auto expect_same = [&] {
+        nvl::Random queries(0xBEEF);
+        List<Box<2>> volumes;
+        for (U64 i = 0; i < 100; ++i) {
+            const auto min = queries.uniform<Pos<2>, I64>(-250, 250);
+            volumes.push_back(Box<2>(min, min + queries.uniform<Pos<2>, I64>(0, 60)));
+            EXPECT_EQ(ids_in(grid, volumes.back()), brute_force_ids(boxes, volumes.back())) << volumes.back();
+        }
+        List<Set<U64>> found(volumes.size());
+        grid.query_many(volumes.range(), [&](const U64 i, const Ref<LabeledBox> &item) { found[i].insert(item->id()); });
+        for (U64 i = 0; i < volumes.size(); ++i) {
+            EXPECT_EQ(found[i], brute_force_ids(boxes, volumes[i]));
+        }
+    };
+    expect_same();
+
+    for (U64 i = 0; i < 300; i += 2) {
+        const Box<2> prev = refs[i]->bbox();
+        const Pos<2> delta = random.uniform<Pos<2>, I64>(-20, 20);
+        *refs[i] = *refs[i] + delta;
+        boxes[i] = boxes[i] + delta;
+        grid.move(refs[i], prev);
+    }
+    expect_same();
+}
+
+TEST(TestHashGrid, any_index) {
+    using Index = AnyIndex<2, LabeledBox, Ref<LabeledBox>, Tree, Grid>;
+    Index tree;
+    Index grid(std::in_place_type<Grid>);
+    EXPECT_NE(tree.get<Tree>(), nullptr);
+    EXPECT_NE(grid.get<Grid>(), nullptr);
+
+    nvl::Random random(0xDEADBEEF);
+    for (U64 i = 0; i < 100; ++i) {
+        const auto min = random.uniform<Pos<2>, I64>(-100, 100);
+        const LabeledBox box(i, Box<2>(min, min + random.uniform<Pos<2>, I64>(0, 20)));
+        tree.insert(box);
+        grid.insert(box);
+    }
+    const Box<2> volume({-30, -30}, {30, 30});
+    EXPECT_EQ(ids_in(grid, volume), ids_in(tree, volume));
+
+    grid.reset<Tree>();
+    EXPECT_TRUE(grid.empty());
+    EXPECT_NE(grid.get<Tree>(), nullptr);
+}
+
+} // namespace
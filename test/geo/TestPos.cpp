@@ -1,6 +1,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <type_traits>
+
 #include "nvl/data/Map.h"
 #include "nvl/geo/Pos.h"
 
@@ -9,6 +11,7 @@ namespace {
 using nvl::Map;
 using nvl::None;
 using nvl::Pos;
+using nvl::Pos32;
 
 using testing::ElementsAre;
 
@@ -235,4 +238,30 @@ TEST(TestPos, hash) {
     EXPECT_EQ(hash(a), hash(c));
 }
 
+TEST(TestPos, compact) {
+    static_assert(sizeof(Pos32<2>) == sizeof(Pos<2>) / 2);
+    static_assert(std::is_convertible_v<Pos32<3>, Pos<3>>);  // Widening is implicit
+    static_assert(!std::is_convertible_v<Pos<3>, Pos32<3>>); // Narrowing must be explicit
+
+    constexpr Pos32<3> a{-1, 2, 2147483647};
+    const Pos<3> b = a;
+    EXPECT_THAT(b, ElementsAre(-1, 2, 2147483647));
+    EXPECT_EQ(Pos32<3>(b), a);
+    EXPECT_THAT(a + Pos32<3>(1, 1, -1), ElementsAre(0, 3, 2147483646));
+    EXPECT_EQ(Pos32<3>::fill(3) * 2, Pos32<3>(6, 6, 6));
+    EXPECT_EQ(a.manhattan_dist(-a), 2 + 4 + 2 * I64(2147483647));
+
+    Map<Pos32<2>, I64> map;
+    map[Pos32<2>(1, 2)] = 3;
+    EXPECT_EQ(map[Pos32<2>(1, 2)], 3);
+}
+
+TEST(TestPos, compact_overflow) {
+#ifdef NDEBUG
+    GTEST_SKIP() << "Narrowing conversions are only checked in debug builds";
+#else
+    EXPECT_DEATH({ std::cout << Pos32<2>(Pos<2>(0, I64(1) << 32)); }, "overflows 32-bit coordinates");
+#endif
+}
+
 } // namespace
\ No newline at end of file
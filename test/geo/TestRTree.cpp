@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <set>
+#include <utility>
+
 #include "nvl/geo/Box.h"
 #include "nvl/geo/Pos.h"
 #include "nvl/geo/RTree.h"
@@ -33,8 +36,10 @@ namespace {
 
 using testing::IsEmpty;
 using testing::UnorderedElementsAre;
+using testing::UnorderedElementsAreArray;
 
 using nvl::Box;
+using nvl::Box32;
 using nvl::Distribution;
 using nvl::List;
 using nvl::Map;
@@ -103,6 +108,25 @@ TEST(TestRTree, subdivide) {
     EXPECT_THAT(elements, UnorderedElementsAre(b0, b1, b2));
 }
 
+TEST(TestRTree, take_all) {
+    RTree<2, LabeledBox, Ref<LabeledBox>, /*max_entries*/ 2> tree;
+    std::vector<std::unique_ptr<LabeledBox>> items;
+    items.push_back(std::make_unique<LabeledBox>(0, Box<2>({0, 5}, {10, 20})));
+    items.push_back(std::make_unique<LabeledBox>(1, Box<2>({10, 100}, {20, 120})));
+    items.push_back(std::make_unique<LabeledBox>(2, Box<2>({100, 200}, {200, 200})));
+    const List<Ref<LabeledBox>> refs = tree.take(std::move(items));
+    ASSERT_EQ(refs.size(), 3);
+    EXPECT_EQ(refs[0]->id(), 0);
+    EXPECT_EQ(refs[2]->id(), 2);
+
+    // Same layout as inserting the items one at a time
+    const Map<Box<2>, Set<U64>> expected{{Box<2>({0, 0}, {127, 127}), Set<U64>{0, 1}},
+                                         {Box<2>({0, 128}, {127, 255}), Set<U64>{2}},
+                                         {Box<2>({128, 128}, {255, 255}), Set<U64>{2}}};
+    EXPECT_EQ(collect_ids(tree), expected);
+    EXPECT_THAT(List<Ref<LabeledBox>>(tree[tree.bbox()]), UnorderedElementsAreArray(refs));
+}
+
 TEST(TestRTree, bracket_operator) {
     RTree<2, LabeledBox> tree;
     tree.insert({1, {{0, 0}, {1512, 982}}});
@@ -206,6 +230,439 @@ TEST(TestRTree, components_pairs) {
     EXPECT_THAT(tree.components(), UnorderedElementsAre(Comp{a, b}, Comp{c, d}));
 }
 
+TEST(TestRTree, move_within_cells) {
+    // Use a grid size of 4 so that the item spans several cells
+    RTree<2, LabeledBox, Ref<LabeledBox>, /*max_entries*/ 10, /*grid_exp_min*/ 2, /*grid_exp_max*/ 2> tree;
+    Ref<LabeledBox> item = tree.emplace(0, Box<2>({0, 0}, {3, 9}));
+    const Box<2> prev = item->bbox();
+    *item = *item + Pos<2>(0, 2);
+    tree.move(item, prev);
+
+    // The first cell overlaps both the removed and retained volumes, so it should still contain the item
+    EXPECT_THAT(List<Ref<LabeledBox>>(tree[Pos<2>(0, 2)]), UnorderedElementsAre(item));
+    EXPECT_THAT(List<Ref<LabeledBox>>(tree[Pos<2>(0, 11)]), UnorderedElementsAre(item));
+    EXPECT_THAT(List<Ref<LabeledBox>>(tree[Pos<2>(0, 1)]), IsEmpty());
+    // Each cell should only reference the item once
+    EXPECT_EQ(tree.stats().references, 3);
+}
+
+TEST(TestRTree, stats) {
+    RTree<2, LabeledBox, Ref<LabeledBox>, /*max_entries*/ 2> tree;
+    tree.emplace(0, Box<2>({0, 5}, {10, 20}));
+    tree.emplace(1, Box<2>({10, 100}, {20, 120}));
+    tree.emplace(2, Box<2>({100, 200}, {200, 200}));
+
+    const auto stats = tree.stats();
+    EXPECT_EQ(stats.items, 3);
+    EXPECT_EQ(stats.nodes, 4);
+    EXPECT_EQ(stats.depth, 4);
+    EXPECT_THAT(List<U64>(stats.nodes_per_level.begin(), stats.nodes_per_level.begin() + 5),
+                testing::ElementsAre(1, 1, 1, 1, 0));
+    EXPECT_EQ(stats.list_entries, 3);
+    EXPECT_EQ(stats.node_entries, 3);
+    EXPECT_EQ(stats.empty_entries, 0);
+    EXPECT_EQ(stats.empty_nodes, 0);
+    EXPECT_EQ(stats.references, 4);
+    EXPECT_DOUBLE_EQ(stats.duplication(), 4.0 / 3.0);
+    EXPECT_EQ(stats.list_lengths[1], 2);
+    EXPECT_EQ(stats.list_lengths[2], 1);
+    EXPECT_GT(stats.memory, 0);
+    EXPECT_EQ(stats.queries, 0);
+}
+
+TEST(TestRTree, incremental_depth) {
+    RTree<2, LabeledBox, Ref<LabeledBox>, /*max_entries*/ 2> tree;
+    EXPECT_EQ(tree.depth(), 1);
+    const auto b0 = tree.emplace(0, Box<2>({0, 5}, {10, 20}));
+    const auto b1 = tree.emplace(1, Box<2>({10, 100}, {20, 120}));
+    EXPECT_EQ(tree.depth(), 1);
+    const auto b2 = tree.emplace(2, Box<2>({100, 200}, {200, 200}));
+    EXPECT_EQ(tree.depth(), 4);
+
+    tree.remove(b2);
+    tree.remove(b1);
+    tree.remove(b0);
+    EXPECT_EQ(tree.nodes(), 1);
+    EXPECT_EQ(tree.depth(), 1);
+
+    tree.clear();
+    EXPECT_EQ(tree.depth(), 1);
+}
+
+TEST(TestRTree, release_and_rebuild) {
+    RTree<2, LabeledBox, Ref<LabeledBox>, /*max_entries*/ 2> tree;
+    const auto b0 = tree.emplace(0, Box<2>({0, 5}, {10, 20}));
+    const auto b1 = tree.emplace(1, Box<2>({10, 100}, {20, 120}));
+    const auto b2 = tree.emplace(2, Box<2>({100, 200}, {200, 200}));
+    EXPECT_EQ(tree.depth(), 4);
+
+    const std::unique_ptr<LabeledBox> released = tree.release(b2);
+    ASSERT_NE(released, nullptr);
+    EXPECT_EQ(released->id(), 2);
+    EXPECT_FALSE(tree.has(b2));
+    EXPECT_EQ(tree.size(), 2);
+    EXPECT_EQ(tree.release(b2), nullptr);
+
+    // Nodes split while the tree held more items are only collapsed by rebuilding
+    EXPECT_EQ(tree.depth(), 4);
+    tree.rebuild();
+    EXPECT_EQ(tree.depth(), 1);
+    EXPECT_EQ(tree.bbox(), Box<2>({0, 5}, {20, 120}));
+    EXPECT_EQ(List<Ref<LabeledBox>>(tree[Box<2>({0, 0}, {50, 50})]), List<Ref<LabeledBox>>{b0});
+    EXPECT_EQ(List<Ref<LabeledBox>>(tree[Box<2>({0, 0}, {50, 150})]).size(), 2);
+    EXPECT_TRUE(tree.has(b1));
+}
+
+TEST(TestRTree, query_counters) {
+    RTree<2, LabeledBox> tree;
+    tree.emplace(0, Box<2>({0, 0}, {10, 10}));
+    tree.emplace(1, Box<2>({2000, 0}, {2010, 10}));
+
+    U64 found = List<Ref<LabeledBox>>(tree[Box<2>({0, 0}, {2047, 10})]).size();
+    EXPECT_EQ(found, 2);
+    EXPECT_EQ(tree.stats().queries, 0); // Not counted by default
+
+    tree.count_queries(true);
+    found = List<Ref<LabeledBox>>(tree[Box<2>({0, 0}, {2047, 10})]).size();
+    EXPECT_EQ(found, 2);
+    const auto stats = tree.stats();
+    EXPECT_EQ(stats.queries, 1);
+    EXPECT_EQ(stats.cells_visited, 2);
+    EXPECT_DOUBLE_EQ(stats.cells_per_query(), 2);
+}
+
+TEST(TestRTree, query_many) {
+    using Tree = RTree<2, LabeledBox>;
+    for (const Tree::Layout layout : {Tree::Layout::kGrid, Tree::Layout::kLoose}) {
+        nvl::Random random(0xDEADBEEF);
+        Tree tree(layout);
+        for (U64 i = 0; i < 500; ++i) {
+            // Include a few large boxes, which are listed in coarser grids of the loose layout
+            tree.emplace(i, random.uniform<Box<2>, I64>(-500, 500) * (i % 50 == 0 ? 4 : 1));
+        }
+        List<Box<2>> queries;
+        for (U64 i = 0; i < 200; ++i) {
+            queries.push_back(random.uniform<Box<2>, I64>(-600, 600));
+        }
+        queries.push_back(Box<2>({-2000, -2000}, {2000, 2000})); // Spans several root cells
+
+        List<Set<U64>> found(queries.size());
+        tree.query_many(queries.range(), [&](const U64 i, const Ref<LabeledBox> &item) {
+            EXPECT_FALSE(found[i].has(item->id())) << "Item " << item->id() << " reported twice for query " << i;
+            found[i].insert(item->id());
+        });
+        for (U64 i = 0; i < queries.size(); ++i) {
+            Set<U64> expected;
+            for (const Ref<LabeledBox> &item : tree[queries[i]]) {
+                expected.insert(item->id());
+            }
+            EXPECT_EQ(found[i], expected) << "Query " << i << ": " << queries[i];
+        }
+        EXPECT_EQ(found.back().size(), 500);
+    }
+}
+
+TEST(TestRTree, loose_query_many_visits_cells_once) {
+    using Tree = RTree<2, LabeledBox>;
+    Tree tree(Tree::Layout::kLoose);
+    tree.emplace(0, Box<2>({0, 0}, {3, 3}));
+    tree.emplace(1, Box<2>({1, 1}, {2, 2}));
+    tree.count_queries(true);
+
+    // Both volumes overlap the one loose cell listing both items, which is visited once for both
+    const List<Box<2>> queries{Box<2>({0, 0}, {1, 1}), Box<2>({2, 2}, {3, 3})};
+    List<Set<U64>> found(queries.size());
+    tree.query_many(queries.range(), [&](const U64 i, const Ref<LabeledBox> &item) { found[i].insert(item->id()); });
+    EXPECT_EQ(found[0], Set<U64>({0, 1}));
+    EXPECT_EQ(found[1], Set<U64>({0, 1}));
+    EXPECT_EQ(tree.stats().queries, 2);
+    EXPECT_EQ(tree.stats().cells_visited, 1);
+}
+
+/// Returns the pairs of ids of items in `a` and `b` within `dist` of each other, found by checking every pair.
+std::set<std::pair<U64, U64>> brute_force_pairs(const List<LabeledBox> &a, const List<LabeledBox> &b, const I64 dist) {
+    std::set<std::pair<U64, U64>> pairs;
+    for (const LabeledBox &x : a) {
+        for (const LabeledBox &y : b) {
+            if (x.bbox().widened(dist).overlaps(y.bbox())) {
+                pairs.insert({x.id(), y.id()});
+            }
+        }
+    }
+    return pairs;
+}
+
+TEST(TestRTree, pairs_within) {
+    nvl::Random random(0xDEADBEEF);
+    List<LabeledBox> boxes;
+    RTree<2, LabeledBox> tree;
+    for (U64 i = 0; i < 300; ++i) {
+        boxes.emplace_back(i, random.uniform<Box<2>, I64>(-300, 300));
+        tree.insert(boxes.back());
+    }
+    boxes.emplace_back(300, Box<2>({-1030, 0}, {-1025, 5})); // Adjacent to the next box across a root cell boundary
+    boxes.emplace_back(301, Box<2>({-1024, 0}, {-1020, 5}));
+    tree.insert(boxes[300]);
+    tree.insert(boxes[301]);
+
+    for (const I64 dist : {0, 1, 10}) {
+        std::set<std::pair<U64, U64>> expected;
+        for (const auto &[a, b] : brute_force_pairs(boxes, boxes, dist)) {
+            if (a < b) {
+                expected.insert({a, b});
+            }
+        }
+        std::set<std::pair<U64, U64>> found;
+        tree.pairs_within(dist, [&](const Ref<LabeledBox> &a, const Ref<LabeledBox> &b) {
+            const std::pair<U64, U64> pair = std::minmax(a->id(), b->id());
+            EXPECT_FALSE(found.contains(pair)) << "Pair " << pair.first << ", " << pair.second << " reported twice";
+            found.insert(pair);
+        });
+        EXPECT_EQ(found, expected) << "Distance " << dist;
+        EXPECT_TRUE(dist == 0 || found.contains({300, 301}));
+    }
+}
+
+TEST(TestRTree, join) {
+    nvl::Random random(0xDEADBEEF);
+    List<LabeledBox> a_boxes, b_boxes;
+    RTree<2, LabeledBox> a, b;
+    for (U64 i = 0; i < 200; ++i) {
+        a_boxes.emplace_back(i, random.uniform<Box<2>, I64>(-200, 200));
+        a.insert(a_boxes.back());
+    }
+    for (U64 i = 0; i < 50; ++i) {
+        b_boxes.emplace_back(i, random.uniform<Box<2>, I64>(-50, 50) * 4); // Larger boxes, so nodes are split differently
+        b.insert(b_boxes.back());
+    }
+    std::set<std::pair<U64, U64>> found;
+    a.join(b, 1, [&](const Ref<LabeledBox> &x, const Ref<LabeledBox> &y) {
+        EXPECT_FALSE(found.contains({x->id(), y->id()}));
+        found.insert({x->id(), y->id()});
+    });
+    EXPECT_EQ(found, brute_force_pairs(a_boxes, b_boxes, 1));
+}
+
+/// Returns the ids of the items in `tree` overlapping `box`.
+template <typename Tree>
+Set<U64> ids_in(const Tree &tree, const Box<2> &box) {
+    Set<U64> ids;
+    for (const Ref<LabeledBox> &item : tree[box]) {
+        EXPECT_FALSE(ids.has(item->id())) << "Item " << item->id() << " reported twice";
+        ids.insert(item->id());
+    }
+    return ids;
+}
+
+TEST(TestRTree, loose_layout) {
+    using Tree = RTree<2, LabeledBox>;
+    nvl::Random random(0xDEADBEEF);
+    Tree grid;
+    Tree loose(Tree::Layout::kLoose);
+    Map<U64, std::pair<Ref<LabeledBox>, Ref<LabeledBox>>> items;
+    for (U64 i = 0; i < 500; ++i) {
+        // Include a few large boxes, which span many cells of the grid
+        const Box<2> box = random.uniform<Box<2>, I64>(-500, 500) * (i % 50 == 0 ? 20 : 1);
+        items[i] = {grid.emplace(i, box), loose.emplace(i, box)};
+    }
+    EXPECT_EQ(loose.stats().references, 500);
+    EXPECT_DOUBLE_EQ(loose.stats().duplication(), 1.0);
+    EXPECT_GT(grid.stats().duplication(), 1.0);
+
+    const auto expect_same = [&] {
+        nvl::Random queries(0xBEEF);
+        for (U64 i = 0; i < 200; ++i) {
+            const Box<2> box = queries.uniform<Box<2>, I64>(-600, 600);
+            EXPECT_EQ(ids_in(loose, box), ids_in(grid, box)) << "Query " << box;
+        }
+        EXPECT_EQ(ids_in(loose, Box<2>({-20000, -20000}, {20000, 20000})).size(), grid.size());
+    };
+    expect_same();
+
+    // Move some items, across grids as well as within them, and remove others
+    for (U64 i = 0; i < 500; i += 3) {
+        auto &[a, b] = items[i];
+        const Box<2> prev = a->bbox();
+        const Pos<2> delta = random.uniform<Pos<2>, I64>(-40, 40);
+        *a = *a + delta;
+        *b = *b + delta;
+        grid.move(a, prev);
+        loose.move(b, prev);
+    }
+    for (U64 i = 1; i < 500; i += 7) {
+        grid.remove(items[i].first);
+        loose.remove(items[i].second);
+    }
+    EXPECT_EQ(loose.size(), grid.size());
+    EXPECT_EQ(loose.stats().references, loose.size());
+    expect_same();
+
+    loose.rebuild();
+    expect_same();
+}
+
+TEST(TestRTree, morton_keys) {
+    using MortonTree = RTree<2, LabeledBox, Ref<LabeledBox>, 10, 2, 10, nvl::NoSummary, nvl::MortonKeys<2>>;
+    nvl::Random random(0xDEADBEEF);
+    RTree<2, LabeledBox> tree;
+    MortonTree morton;
+    Map<U64, std::pair<Ref<LabeledBox>, Ref<LabeledBox>>> items;
+    for (U64 i = 0; i < 500; ++i) {
+        const Box<2> box = random.uniform<Box<2>, I64>(-2000, 2000);
+        items[i] = {tree.emplace(i, box), morton.emplace(i, box)};
+    }
+    EXPECT_EQ(morton.nodes(), tree.nodes());
+    EXPECT_EQ(morton.stats().references, tree.stats().references);
+
+    const auto expect_same = [&] {
+        nvl::Random queries(0xBEEF);
+        for (U64 i = 0; i < 200; ++i) {
+            const Box<2> box = queries.uniform<Box<2>, I64>(-2500, 2500) * 2;
+            EXPECT_EQ(ids_in(morton, box), ids_in(tree, box)) << "Query " << box;
+        }
+    };
+    expect_same();
+
+    for (U64 i = 0; i < 500; i += 3) {
+        auto &[a, b] = items[i];
+        const Box<2> prev = a->bbox();
+        const Pos<2> delta = random.uniform<Pos<2>, I64>(-40, 40);
+        *a = *a + delta;
+        *b = *b + delta;
+        tree.move(a, prev);
+        morton.move(b, prev);
+    }
+    for (U64 i = 1; i < 500; i += 7) {
+        tree.remove(items[i].first);
+        morton.remove(items[i].second);
+    }
+    expect_same();
+    EXPECT_EQ(morton.components().size(), tree.components().size());
+}
+
+TEST(TestRTree, compact_items) {
+    nvl::Random random(0xDEADBEEF);
+    RTree<2, Box<2>> tree;
+    RTree<2, Box32<2>> compact;
+    for (U64 i = 0; i < 500; ++i) {
+        const Box<2> box = random.uniform<Box<2>, I64>(-2000, 2000);
+        tree.insert(box);
+        compact.insert(Box32<2>(box));
+    }
+    compact.emplace(nvl::Pos32<2>(-3000, 0), nvl::Pos32<2>(3000, 0));
+    tree.emplace(Pos<2>(-3000, 0), Pos<2>(3000, 0));
+    EXPECT_EQ(compact.nodes(), tree.nodes());
+    EXPECT_EQ(compact.bbox(), tree.bbox());
+
+    nvl::Random queries(0xBEEF);
+    for (U64 i = 0; i < 200; ++i) {
+        const Box<2> box = queries.uniform<Box<2>, I64>(-2500, 2500);
+        List<Box<2>> expected, actual;
+        for (const Ref<Box<2>> &item : tree[box]) {
+            expected.push_back(*item);
+        }
+        for (const Ref<Box32<2>> &item : compact[box]) {
+            actual.push_back(*item);
+        }
+        EXPECT_THAT(actual, UnorderedElementsAreArray(expected)) << "Query " << box;
+    }
+}
+
+TEST(TestRTree, loose_join) {
+    using Tree = RTree<2, LabeledBox>;
+    nvl::Random random(0xDEADBEEF);
+    List<LabeledBox> boxes;
+    Tree grid;
+    Tree loose(Tree::Layout::kLoose);
+    for (U64 i = 0; i < 300; ++i) {
+        boxes.emplace_back(i, random.uniform<Box<2>, I64>(-300, 300));
+        grid.insert(boxes.back());
+        loose.insert(boxes.back());
+    }
+    std::set<std::pair<U64, U64>> found;
+    loose.pairs_within(1, [&](const Ref<LabeledBox> &a, const Ref<LabeledBox> &b) {
+        const std::pair<U64, U64> pair = std::minmax(a->id(), b->id());
+        EXPECT_FALSE(found.contains(pair)) << "Pair " << pair.first << ", " << pair.second << " reported twice";
+        found.insert(pair);
+    });
+    std::set<std::pair<U64, U64>> expected;
+    for (const auto &[a, b] : brute_force_pairs(boxes, boxes, 1)) {
+        if (a < b) {
+            expected.insert({a, b});
+        }
+    }
+    EXPECT_EQ(found, expected);
+
+    // Joining trees with different layouts
+    found.clear();
+    grid.join(loose, 1, [&](const Ref<LabeledBox> &a, const Ref<LabeledBox> &b) { found.insert({a->id(), b->id()}); });
+    EXPECT_EQ(found, brute_force_pairs(boxes, boxes, 1));
+    EXPECT_EQ(loose.components().size(), grid.components().size());
+}
+
+/// Flags of a labeled box, with one of four flags set depending on its id.
+struct LabelFlags {
+    pure U64 operator()(const LabeledBox &box) const { return U64(1) << (box.id() % 4); }
+};
+
+/// Tree summarizing both the union of the flags of its items and their bounds.
+struct LabelSummary {
+    using Flags = nvl::FlagSummary<LabelFlags>;
+    using Bounds = nvl::BoundsSummary<2>;
+    using Value = std::pair<Flags::Value, Bounds::Value>;
+    pure static Value identity() { return {Flags::identity(), Bounds::identity()}; }
+    pure static Value of(const LabeledBox &box) { return {Flags::of(box), Bounds::of(box)}; }
+    pure static Value combine(const Value &a, const Value &b) {
+        return {Flags::combine(a.first, b.first), Bounds::combine(a.second, b.second)};
+    }
+};
+
+TEST(TestRTree, summaries) {
+    using Tree = RTree<2, LabeledBox, Ref<LabeledBox>, 10, 2, 10, LabelSummary>;
+    for (const Tree::Layout layout : {Tree::Layout::kGrid, Tree::Layout::kLoose}) {
+        nvl::Random random(0xDEADBEEF);
+        Tree tree(layout);
+        List<Ref<LabeledBox>> items;
+        for (U64 i = 0; i < 400; ++i) {
+            items.push_back(tree.emplace(i, random.uniform<Box<2>, I64>(-1500, 1500)));
+        }
+        // Remove some items and move others, including across root cells
+        for (U64 i = 0; i < 100; ++i) {
+            tree.remove(items[i]);
+        }
+        for (U64 i = 100; i < 200; ++i) {
+            const Box<2> prev = items[i]->bbox();
+            *items[i] = *items[i] + random.uniform<Pos<2>, I64>(-300, 300);
+            tree.move(items[i], prev);
+        }
+
+        for (U64 i = 0; i < 100; ++i) {
+            const Box<2> box =
+                Box<2>(random.uniform<Pos<2>, I64>(-1600, 1600), random.uniform<Pos<2>, I64>(-1600, 1600));
+            U64 count = 0;
+            LabelSummary::Value expected = LabelSummary::identity();
+            for (const Ref<LabeledBox> &item : tree[box]) {
+                count += 1;
+                expected = LabelSummary::combine(expected, LabelSummary::of(*item));
+            }
+            EXPECT_EQ(tree.count_in(box), count) << box;
+            EXPECT_EQ(tree.summary(box), expected) << box;
+            for (U64 flag = 0; flag < 4; ++flag) {
+                const bool any = tree.any_in(box, [&](const LabelSummary::Value &v) { return (v.first >> flag) & 1; });
+                EXPECT_EQ(any, (expected.first >> flag) & 1) << box;
+            }
+        }
+    }
+}
+
+TEST(TestRTree, count_without_summary) {
+    RTree<2, LabeledBox> tree;
+    tree.emplace(0, Box<2>({0, 0}, {10, 10}));
+    tree.emplace(1, Box<2>({5, 5}, {2000, 10}));
+    EXPECT_EQ(tree.count_in(Box<2>({0, 0}, {4, 4})), 1);
+    EXPECT_EQ(tree.count_in(Box<2>({0, 0}, {2047, 10})), 2);
+}
+
 TEST(TestRTree, fuzz_insertion) {
     constexpr I64 kNumTests = 1E3;
     RTree<2, Box<2>> tree;
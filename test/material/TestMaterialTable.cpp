@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "nvl/actor/Part.h"
+#include "nvl/material/Bulwark.h"
+#include "nvl/material/Material.h"
+#include "nvl/material/TestMaterial.h"
+
+namespace {
+
+using nvl::AbstractMaterial;
+using nvl::Box;
+using nvl::Bulwark;
+using nvl::Color;
+using nvl::Material;
+using nvl::MaterialTable;
+using nvl::Part;
+using nvl::TestMaterial;
+
+TEST(TestMaterialTable, compact_handle) {
+    EXPECT_EQ(sizeof(Material), sizeof(MaterialTable::Id));
+    EXPECT_LT(sizeof(Part<2>), sizeof(Box<2>) + 2 * sizeof(U64) + sizeof(std::shared_ptr<int>));
+}
+
+TEST(TestMaterialTable, null_material) {
+    const Material material;
+    EXPECT_FALSE(material);
+    EXPECT_EQ(material, nullptr);
+    EXPECT_EQ(material.id(), 0);
+}
+
+/// Returns 1 if no material with the same type and properties as `material` has been added yet, otherwise 0.
+U64 is_new(const AbstractMaterial &material) {
+    return MaterialTable::global().find(MaterialTable::Key::of(material)).has_value() ? 0 : 1;
+}
+
+TEST(TestMaterialTable, register) {
+    // Other tests may have already added these materials
+    const U64 size = MaterialTable::global().size() + is_new(TestMaterial(Color::kBlack)) + is_new(Bulwark());
+    const Material a = Material::get<TestMaterial>(Color::kBlack);
+    const Material b = Material::get<Bulwark>();
+    EXPECT_EQ(MaterialTable::global().size(), size);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(a.isa<TestMaterial>());
+    EXPECT_FALSE(a.isa<Bulwark>());
+    ASSERT_NE(b.dyn_cast<Bulwark>(), nullptr);
+    EXPECT_FALSE(b->falls);
+    EXPECT_EQ(a->color, Color::kBlack);
+}
+
+TEST(TestMaterialTable, shared_properties) {
+    const Material a = Material::get<TestMaterial>(Color::kBlack);
+    const Material copy = a;
+    const Part<2> part(Box<2>({0, 0}, {2, 2}), a);
+    EXPECT_EQ(copy, a);
+    EXPECT_EQ(&*copy, &*a);
+    EXPECT_EQ(part.material, a);
+    EXPECT_EQ(part.health, a->durability);
+}
+
+TEST(TestMaterialTable, interned) {
+    const Material a = Material::get<TestMaterial>(Color::kBlue);
+    const U64 size = MaterialTable::global().size() + is_new(TestMaterial(Color::kGreen));
+    const Material b = Material::get<TestMaterial>(Color::kBlue);
+    const Material c = Material::get<TestMaterial>(Color::kGreen);
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(MaterialTable::global().size(), size);
+    EXPECT_EQ(MaterialTable::global().find(MaterialTable::Key::of(*a)), a.id());
+}
+
+TEST(TestMaterialTable, with) {
+    const Material a = Material::get<TestMaterial>(Color::kWhite);
+    const Material b = a.with([](AbstractMaterial &material) { material.outline = false; });
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(a->outline);
+    EXPECT_FALSE(b->outline);
+    EXPECT_TRUE(b.isa<TestMaterial>());
+    EXPECT_EQ(b->color, Color::kWhite);
+    EXPECT_EQ(Material::get<TestMaterial>(Color::kWhite), a);
+
+    // Modified materials are interned too
+    EXPECT_EQ(a.with([](AbstractMaterial &material) { material.outline = false; }), b);
+    EXPECT_EQ(b.with([](AbstractMaterial &material) { material.outline = true; }), a);
+}
+
+} // namespace
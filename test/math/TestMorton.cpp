@@ -0,0 +1,94 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "nvl/data/List.h"
+#include "nvl/data/Set.h"
+#include "nvl/geo/Box.h"
+#include "nvl/geo/Pos.h"
+#include "nvl/math/Morton.h"
+#include "nvl/math/Random.h"
+
+namespace {
+
+using nvl::Box;
+using nvl::List;
+using nvl::Morton;
+using nvl::Pos;
+using nvl::Set;
+
+/// Returns the code of `cell` by interleaving one bit at a time.
+template <U64 N>
+U64 reference_encode(const Pos<N> &cell) {
+    U64 code = 0;
+    for (U64 d = 0; d < N; ++d) {
+        const U64 index = (static_cast<U64>(cell[d]) & Morton<N>::kMask) ^ Morton<N>::kHalf;
+        for (U64 b = 0; b < Morton<N>::kBits; ++b) {
+            code |= ((index >> b) & 1) << (b * N + d);
+        }
+    }
+    return code;
+}
+
+TEST(TestMorton, encode_2d) {
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(0, 0)), 0xC000000000000000);
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(1, 0)), 0xC000000000000001);
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(0, 1)), 0xC000000000000002);
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(1, 1)), 0xC000000000000003);
+    EXPECT_LT(Morton<2>::encode(Pos<2>(-1, -1)), Morton<2>::encode(Pos<2>(0, 0)));
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(Morton<2>::kMin, Morton<2>::kMin)), 0);
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(Morton<2>::kMax, Morton<2>::kMax)), ~U64(0));
+    EXPECT_FALSE(Morton<2>::fits(Pos<2>(Morton<2>::kMax + 1, 0)));
+
+    // Positions are encoded by the cell containing them
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(7, -1), 4), Morton<2>::encode(Pos<2>(1, -1)));
+    EXPECT_EQ(Morton<2>::encode(Pos<2>(-4, -5), 4), Morton<2>::encode(Pos<2>(-1, -2)));
+}
+
+template <U64 N>
+void expect_round_trip() {
+    nvl::Random random(0xDEADBEEF);
+    for (U64 i = 0; i < 1000; ++i) {
+        const auto cell = random.uniform<Pos<N>, I64>(Morton<N>::kMin, Morton<N>::kMax);
+        const U64 code = Morton<N>::encode(cell);
+        EXPECT_EQ(code, reference_encode(cell)) << cell;
+        EXPECT_EQ(Morton<N>::decode(code), cell);
+    }
+}
+
+TEST(TestMorton, round_trip) {
+    expect_round_trip<1>();
+    expect_round_trip<2>();
+    expect_round_trip<3>();
+    expect_round_trip<4>();
+}
+
+template <U64 N>
+void expect_cells_in(const Box<N> &box, const I64 grid) {
+    Set<Pos<N>> expected;
+    for (const Pos<N> &pos : box.clamp(grid).pos_iter(grid)) {
+        expected.insert(pos);
+    }
+    List<Pos<N>> cells(Morton<N>::cells_in(box, grid));
+    EXPECT_EQ(Set<Pos<N>>(cells.begin(), cells.end()), expected) << box;
+    EXPECT_EQ(cells.size(), expected.size()) << box;
+    for (U64 i = 1; i < cells.size(); ++i) {
+        EXPECT_LT(Morton<N>::encode(cells[i - 1], grid), Morton<N>::encode(cells[i], grid));
+    }
+}
+
+TEST(TestMorton, cells_in) {
+    expect_cells_in(Box<2>({0, 0}, {3, 3}), 1);
+    expect_cells_in(Box<2>({-5, 2}, {9, 3}), 1);
+    expect_cells_in(Box<2>({-37, -100}, {50, 12}), 8);
+    expect_cells_in(Box<3>({-3, 1, -7}, {4, 6, 2}), 1);
+    expect_cells_in(Box<3>({-30, 100, -7}, {40, 160, 20}), 16);
+
+    nvl::Random random(0xDEADBEEF);
+    for (U64 i = 0; i < 100; ++i) {
+        const auto min = random.uniform<Pos<2>, I64>(-200, 200);
+        const auto shape = random.uniform<Pos<2>, I64>(0, 100);
+        expect_cells_in(Box<2>(min, min + shape), 4);
+    }
+}
+
+} // namespace
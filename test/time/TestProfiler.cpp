@@ -0,0 +1,101 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "nvl/time/Profiler.h"
+
+namespace {
+
+using nvl::Profiler;
+
+TEST(TestProfiler, metrics) {
+    Profiler profiler;
+    const Profiler::Id a = profiler.timer("a");
+    const Profiler::Id b = profiler.counter("b");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(profiler.timer("a"), a);
+    EXPECT_EQ(profiler.metric(a).kind, Profiler::Kind::kTimer);
+    EXPECT_EQ(profiler.metric(b).kind, Profiler::Kind::kCounter);
+    EXPECT_EQ(profiler.metrics().size(), 2);
+}
+
+TEST(TestProfiler, summary) {
+    Profiler profiler;
+    const Profiler::Id id = profiler.counter("count");
+    for (U64 i = 1; i <= 100; ++i) {
+        profiler.add(id, i);
+        profiler.add(id, i);
+        profiler.end_frame();
+    }
+    const Profiler::Summary summary = profiler.summary(id);
+    EXPECT_EQ(summary.frames, 100);
+    EXPECT_EQ(summary.calls, 200);
+    EXPECT_EQ(summary.min, 2);
+    EXPECT_EQ(summary.max, 200);
+    EXPECT_EQ(summary.last, 200);
+    EXPECT_EQ(summary.mean, 101);
+    EXPECT_EQ(summary.p50, 100);
+    EXPECT_EQ(summary.p99, 198);
+    EXPECT_EQ(summary.histogram[2], 1);  // [2, 4)
+    EXPECT_EQ(summary.histogram[8], 37); // [128, 256)
+}
+
+TEST(TestProfiler, rolling_window) {
+    Profiler profiler;
+    const Profiler::Id id = profiler.counter("count");
+    for (U64 i = 0; i < Profiler::kHistory; ++i) {
+        profiler.add(id, 1000);
+        profiler.end_frame();
+    }
+    for (U64 i = 0; i < Profiler::kHistory; ++i) {
+        profiler.add(id, 1);
+        profiler.end_frame();
+    }
+    const Profiler::Summary summary = profiler.summary(id);
+    EXPECT_EQ(summary.frames, Profiler::kHistory);
+    EXPECT_EQ(summary.max, 1);
+
+    profiler.reset();
+    EXPECT_EQ(profiler.frames(), 0);
+    EXPECT_EQ(profiler.summary(id).frames, 0);
+}
+
+TEST(TestProfiler, scope) {
+    Profiler profiler;
+    const Profiler::Id id = profiler.timer("scope");
+    {
+        const Profiler::Scope scope(id, profiler);
+    }
+    profiler.end_frame();
+    EXPECT_EQ(profiler.summary(id).calls, 1);
+}
+
+TEST(TestProfiler, write_csv) {
+    Profiler profiler;
+    const Profiler::Id a = profiler.counter("a");
+    const Profiler::Id b = profiler.counter("b");
+    profiler.add(a, 1);
+    profiler.end_frame();
+    profiler.add(b, 2);
+    profiler.end_frame();
+
+    std::stringstream ss;
+    profiler.write_csv(ss);
+    EXPECT_EQ(ss.str(), "frame,a,b\n0,1,0\n1,0,2\n");
+}
+
+TEST(TestProfiler, write_json) {
+    Profiler profiler;
+    const Profiler::Id a = profiler.counter("a");
+    profiler.add(a, 3);
+    profiler.end_frame();
+
+    std::stringstream ss;
+    profiler.write_json(ss);
+    EXPECT_EQ(ss.str(), "{\"frames\": 1, \"window\": 1, \"metrics\": [{\"name\": \"a\", \"kind\": \"counter\", "
+                        "\"calls\": 1, \"min\": 3, \"mean\": 3, \"p50\": 3, \"p99\": 3, \"max\": 3, "
+                        "\"histogram\": [0, 0, 1]}]}");
+}
+
+} // namespace
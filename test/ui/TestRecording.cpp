@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "nvl/App.h"
+#include "nvl/test/TensorWindow.h"
+#include "nvl/ui/Recording.h"
+#include "nvl/world/Snapshot.h"
+#include "nvl/world/World.h"
+
+namespace {
+
+using nvl::InputEvent;
+using nvl::List;
+using nvl::Mouse;
+using nvl::MouseDown;
+using nvl::MouseMove;
+using nvl::MouseUp;
+using nvl::Pos;
+using nvl::Recording;
+using nvl::Replayer;
+using nvl::Snapshot;
+using nvl::World;
+using nvl::test::TensorWindow;
+
+std::string to_string(const Recording &recording) {
+    std::stringstream ss;
+    recording.write(ss);
+    return ss.str();
+}
+
+std::string to_bytes(const World<2> &world) {
+    std::stringstream ss;
+    Snapshot<2>::write(world, ss);
+    return ss.str();
+}
+
+/// Moves the view by moving the mouse, then creates a block at the center of the view.
+void create_block(Recording &recording, const Pos<2> &from, const Pos<2> &to) {
+    recording.feed(from, Pos<2>::zero, {});
+    recording.feed(to, Pos<2>::zero, {InputEvent::get<MouseMove>(nvl::Set<Mouse>{})});
+    recording.feed(to, Pos<2>::zero, {InputEvent::get<MouseDown>(Mouse::Left)});
+    recording.feed(to, Pos<2>::zero, {InputEvent::get<MouseUp>(Mouse::Left)});
+    for (U64 i = 0; i < 20; ++i) {
+        recording.tick();
+    }
+}
+
+TEST(TestRecording, read_write) {
+    Recording recording;
+    recording.seed = 1234;
+    recording.shape = {100, 50};
+    recording.tick();
+    recording.feed(Pos<2>(1, 2), Pos<2>(0, -1), {InputEvent::get<MouseMove>(nvl::Set<Mouse>{Mouse::Left})});
+    recording.feed(Pos<2>(1, 2), Pos<2>(0, -1), {}); // Skipped since nothing changed
+    recording.tick();
+    recording.tick();
+    recording.feed(nvl::None, Pos<2>::zero, {InputEvent::get<MouseUp>(Mouse::Left)});
+    EXPECT_EQ(recording.frames.size(), 5);
+    EXPECT_EQ(recording.num_ticks(), 3);
+
+    std::stringstream ss(to_string(recording));
+    const nvl::Maybe<Recording> read = Recording::read(ss);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_EQ(read->seed, 1234);
+    EXPECT_EQ(read->shape, Pos<2>(100, 50));
+    EXPECT_EQ(read->frames.size(), 5);
+    EXPECT_EQ(to_string(*read), to_string(recording));
+
+    for (const std::string feed : {"feed 0 0 0 0 Unknown:1", "feed 0 0 0 0 KeyUp:x", "feed 0 0 0 0 KeyUp:",
+                                   "feed 0 0 0 0 MouseMove:1,y", "feed 0 0 0 0 MouseDown:99999999999", "feed a b 0 0",
+                                   "feed 0 - 0 0"}) {
+        std::stringstream bad("nvl-recording 1\nseed 1\nshape 1 1\n" + feed + "\n");
+        EXPECT_FALSE(Recording::read(bad).has_value()) << feed;
+    }
+}
+
+TEST(TestRecording, replay) {
+    Recording session;
+    session.seed = 42;
+    session.shape = {100, 100};
+    create_block(session, {50, 50}, {60, 40});
+    create_block(session, {60, 40}, {30, 45});
+
+    // Replaying a session while recording reproduces the session
+    TensorWindow window("Test", session.shape);
+    World<2> *world = nvl::open_app(&window, session.seed);
+    Recording recorded;
+    recorded.seed = world->random.seed();
+    recorded.shape = session.shape;
+    window.record(&recorded);
+    EXPECT_EQ(Replayer(session, &window).run(), 40);
+    window.record(nullptr);
+    EXPECT_EQ(to_string(recorded), to_string(session));
+    EXPECT_EQ(world->num_alive(), 3);
+    EXPECT_EQ(world->view(), Pos<2>(-20, -5));
+
+    // Replaying the same recording into a new world reproduces the same world
+    TensorWindow replay_window("Test", recorded.shape);
+    World<2> *replay_world = nvl::open_app(&replay_window, recorded.seed);
+    Replayer replayer(recorded, &replay_window);
+    U64 ticks = 0;
+    while (replayer.step()) {
+        ++ticks;
+    }
+    EXPECT_EQ(ticks, 40);
+    EXPECT_EQ(replayer.ticks(), 40);
+    EXPECT_EQ(replay_world->view(), world->view());
+    EXPECT_EQ(to_bytes(*replay_world), to_bytes(*world));
+}
+
+} // namespace
@@ -37,8 +37,9 @@ TEST(TestWindow, draw) {
     TensorWindow window("Test", {10, 10});
     auto *world = window.open<World<2>>();
     world->set_hud(false);
-    auto material = Material::get<nvl::TestMaterial>(Color::kBlack);
-    material->outline = false;
+    const auto material = Material::get<nvl::TestMaterial>(Color::kBlack).with([](nvl::AbstractMaterial &m) {
+        m.outline = false;
+    });
     constexpr Box<2> box({2, 2}, {7, 7});
     world->spawn<Block<2>>(Pos<2>::zero, box, material);
     window.draw();
@@ -63,8 +64,9 @@ TEST_F(FuzzDraw, draw2d) {
     this->in[1] = Distribution::Uniform<I64>(-15, 15);
     this->in[2] = Distribution::Uniform<I64>(-15, 15);
 
-    auto material = Material::get<nvl::TestMaterial>(Color::kBlack);
-    material->outline = false;
+    const auto material = Material::get<nvl::TestMaterial>(Color::kBlack).with([](nvl::AbstractMaterial &m) {
+        m.outline = false;
+    });
 
     fuzz([material](Tensor<2, Color> &tensor, const Pos<2> &offset, const Pos<2> &loc, const Box<2> &box) {
         TensorWindow window("Test", {10, 10});
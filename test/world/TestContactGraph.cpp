@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include "nvl/actor/Actor.h"
+#include "nvl/entity/Block.h"
+#include "nvl/material/Bulwark.h"
+#include "nvl/material/TestMaterial.h"
+#include "nvl/test/NullWindow.h"
+#include "nvl/world/ContactGraph.h"
+#include "nvl/world/World.h"
+
+namespace {
+
+using nvl::Actor;
+using nvl::Block;
+using nvl::Box;
+using nvl::Bulwark;
+using nvl::Color;
+using nvl::ContactGraph;
+using nvl::Dir;
+using nvl::Hit;
+using nvl::List;
+using nvl::Material;
+using nvl::Pos;
+using nvl::TestMaterial;
+using nvl::World;
+using nvl::test::NullWindow;
+
+/// Expects the world's cached contacts of each actor to match contacts computed from scratch.
+void expect_consistent(const World<2> &world, const List<Actor> &actors) {
+    for (const Actor &actor : actors) {
+        const auto *entity = actor.dyn_cast<Block<2>>();
+        EXPECT_TRUE(world.contacts().above(actor) == entity->find_contacts(Dir::Neg)) << "Above " << entity->bbox();
+        EXPECT_TRUE(world.contacts().below(actor) == entity->find_contacts(Dir::Pos)) << "Below " << entity->bbox();
+    }
+}
+
+TEST(TestContactGraph, update_and_remove) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor a = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 0}, {9, 9}), material);
+    const Actor b = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 10}, {9, 19}), material);
+    const Actor c = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({5, 20}, {14, 29}), material);
+
+    ContactGraph<2> graph;
+    graph.update(b, {{a, {Box<2>({0, 9}, {9, 9})}}}, {{c, {Box<2>({5, 20}, {9, 20})}}});
+    EXPECT_EQ(graph.size(), 2);
+    EXPECT_TRUE(graph.has_below(a));
+    EXPECT_TRUE(graph.has_below(b));
+    EXPECT_FALSE(graph.has_below(c));
+    EXPECT_TRUE(graph.below(a).has(b));
+    EXPECT_TRUE(graph.above(c).has(b));
+    EXPECT_EQ(graph.above(c).at(b), List<Box<2>>{Box<2>({5, 20}, {9, 20})});
+
+    // Updating c replaces both sides of its previous contacts
+    graph.update(c, {}, {});
+    EXPECT_EQ(graph.size(), 1);
+    EXPECT_FALSE(graph.has_below(b));
+    EXPECT_TRUE(graph.above(c).empty());
+
+    graph.remove(b);
+    EXPECT_EQ(graph.size(), 0);
+    EXPECT_FALSE(graph.has_below(a));
+    EXPECT_TRUE(graph.below(a).empty());
+}
+
+TEST(TestContactGraph, world_contacts) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor ground = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    const Actor left = world.spawn<Block<2>>(Pos<2>(0, 90), Box<2>({0, 0}, {9, 9}), material);
+    const Actor right = world.spawn<Block<2>>(Pos<2>(10, 90), Box<2>({0, 0}, {9, 9}), material);
+    const Actor bridge = world.spawn<Block<2>>(Pos<2>(5, 80), Box<2>({0, 0}, {9, 9}), material);
+    const List<Actor> actors{ground, left, right, bridge};
+    world.tick();
+
+    EXPECT_EQ(world.contacts().size(), 4);
+    EXPECT_TRUE(bridge.dyn_cast<Block<2>>()->below() == nvl::Set<Actor>({left, right}));
+    EXPECT_EQ(world.contacts().below(bridge).at(left), List<Box<2>>{Box<2>({5, 89}, {9, 89})});
+    expect_consistent(world, actors);
+
+    // Removing the right half of the right block changes its contacts without moving it
+    world.send<Hit<2>>(nullptr, right, Box<2>({15, 90}, {19, 99}), 1000);
+    world.tick();
+    EXPECT_EQ(world.contacts().below(bridge).at(right), List<Box<2>>{Box<2>({10, 89}, {14, 89})});
+    expect_consistent(world, actors);
+}
+
+TEST(TestContactGraph, move_out_of_reach) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor ground = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {9, 110}), bulwark);
+    const Actor block = world.spawn<Block<2>>(Pos<2>(0, 90), Box<2>({0, 0}, {9, 9}), material);
+    EXPECT_TRUE(world.contacts().has_below(block));
+
+    // Sliding off the edge leaves nothing above or below the block, so its previous contacts are removed
+    block.dyn_cast<Block<2>>()->set_velocity(Pos<2>(20, 0));
+    world.tick();
+    EXPECT_EQ(block.dyn_cast<Block<2>>()->bbox(), Box<2>({20, 90}, {29, 99}));
+    EXPECT_FALSE(world.contacts().has_below(block));
+    EXPECT_FALSE(world.contacts().has_above(ground));
+    expect_consistent(world, {ground, block});
+}
+
+TEST(TestContactGraph, falling_stack) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    List<Actor> actors{world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 200}, {100, 210}), bulwark)};
+    for (I64 i = 0; i < 5; ++i) {
+        actors.push_back(world.spawn<Block<2>>(Pos<2>(3 * i, 150 - 20 * i), Box<2>({0, 0}, {9, 9}), material));
+    }
+    for (U64 i = 0; i < 100 && world.num_awake() > 0; ++i) {
+        world.tick();
+        expect_consistent(world, actors);
+    }
+    EXPECT_EQ(world.num_awake(), 0);
+    EXPECT_EQ(world.contacts().size(), 5);
+
+    // Destroying the bottom block removes its contacts
+    world.send<nvl::Destroy>(nullptr, actors[1], nvl::Destroy::kOutOfBounds);
+    world.tick();
+    EXPECT_FALSE(world.contacts().has_below(actors[2]));
+    EXPECT_EQ(world.contacts().above(actors[0]).size(), 0);
+}
+
+} // namespace
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "nvl/actor/Actor.h"
+#include "nvl/entity/Block.h"
+#include "nvl/material/Bulwark.h"
+#include "nvl/material/TestMaterial.h"
+#include "nvl/test/NullWindow.h"
+#include "nvl/world/Snapshot.h"
+#include "nvl/world/World.h"
+
+namespace {
+
+using nvl::Actor;
+using nvl::Block;
+using nvl::Box;
+using nvl::Bulwark;
+using nvl::Color;
+using nvl::Hit;
+using nvl::Material;
+using nvl::Pos;
+using nvl::Snapshot;
+using nvl::TestMaterial;
+using nvl::World;
+using nvl::test::NullWindow;
+
+std::span<const char> as_span(const std::string &bytes) { return {bytes.data(), bytes.size()}; }
+
+std::string to_bytes(const World<2> &world) {
+    std::ostringstream os;
+    Snapshot<2>::write(world, os);
+    return os.str();
+}
+
+/// Spawns terrain with a few blocks in the middle of falling, one of which has been hit.
+void init(World<2> &world) {
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kRed);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 200}, {300, 210}), bulwark);
+    for (I64 i = 0; i < 4; ++i) {
+        world.spawn<Block<2>>(Pos<2>(40 * i, 20 * i), Box<2>({0, 0}, {19, 9}), material);
+    }
+    world.tick();
+    world.tick();
+    const Box<2> hit({0, 0}, {5, 100});
+    world.send<Hit<2>>(nullptr, world.entities(hit), hit, 1);
+    world.tick();
+}
+
+TEST(TestSnapshot, round_trip) {
+    NullWindow window;
+    World<2> world(&window);
+    init(world);
+    const std::string bytes = to_bytes(world);
+    EXPECT_EQ(bytes.size(), sizeof(Snapshot<2>::Header) + 2 * sizeof(Snapshot<2>::MaterialRecord) +
+                                world.num_alive() * sizeof(Snapshot<2>::EntityRecord) +
+                                6 * sizeof(Snapshot<2>::PartRecord));
+
+    World<2> loaded(&window);
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(bytes)), world.num_alive());
+    ASSERT_EQ(loaded.num_alive(), world.num_alive());
+    for (U64 i = 0; i < world.actors().size(); ++i) {
+        const auto *a = world.actors().get(world.actors().id_at(i))->dyn_cast<Block<2>>();
+        const auto *b = loaded.actors().get(loaded.actors().id_at(i))->dyn_cast<Block<2>>();
+        EXPECT_EQ(a->loc(), b->loc());
+        EXPECT_EQ(a->velocity(), b->velocity());
+        EXPECT_EQ(a->accel(), b->accel());
+        EXPECT_EQ(a->bbox(), b->bbox());
+        EXPECT_EQ(a->material(), b->material()); // Materials are interned on load
+        EXPECT_EQ(a->falls(), b->falls());
+    }
+    EXPECT_EQ(loaded.static_entities().size(), world.static_entities().size());
+    EXPECT_EQ(to_bytes(loaded), bytes);
+
+    // Both worlds continue to simulate identically
+    for (U64 i = 0; i < 50; ++i) {
+        world.tick();
+        loaded.tick();
+    }
+    EXPECT_EQ(to_bytes(loaded), to_bytes(world));
+}
+
+TEST(TestSnapshot, mapped_file) {
+    NullWindow window;
+    World<2> world(&window);
+    init(world);
+    const std::string path = testing::TempDir() + "/TestSnapshot.nvls";
+    ASSERT_TRUE(Snapshot<2>::save(world, path));
+
+    World<2> loaded(&window);
+    EXPECT_EQ(Snapshot<2>::load(loaded, path), world.num_alive());
+    EXPECT_EQ(to_bytes(loaded), to_bytes(world));
+
+    World<2> missing(&window);
+    EXPECT_EQ(Snapshot<2>::load(missing, path + ".missing"), nvl::None);
+}
+
+TEST(TestSnapshot, invalid) {
+    NullWindow window;
+    World<2> world(&window);
+    init(world);
+    const std::string bytes = to_bytes(world);
+    World<2> loaded(&window);
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(bytes).first(bytes.size() - 1)), nvl::None);
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(bad_magic)), nvl::None);
+    World<3> world3(&window);
+    EXPECT_EQ(Snapshot<3>::read(world3, as_span(bytes)), nvl::None);
+
+    // Counts whose record sizes wrap around to the same total size
+    Snapshot<2>::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    std::string wrapped_count = bytes;
+    Snapshot<2>::Header bad_header = header;
+    bad_header.materials += U64(1) << 61;
+    std::memcpy(wrapped_count.data(), &bad_header, sizeof(bad_header));
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(wrapped_count)), nvl::None);
+
+    // Part ranges which wrap around
+    const U64 entities_offset = sizeof(header) + header.materials * sizeof(Snapshot<2>::MaterialRecord);
+    std::string wrapped_parts = bytes;
+    Snapshot<2>::EntityRecord record;
+    std::memcpy(&record, bytes.data() + entities_offset, sizeof(record));
+    record.first_part = ~U64(0);
+    record.num_parts = 2;
+    std::memcpy(wrapped_parts.data() + entities_offset, &record, sizeof(record));
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(wrapped_parts)), nvl::None);
+
+    // Parts with boxes which are inverted in a dimension
+    const U64 parts_offset = entities_offset + header.entities * sizeof(Snapshot<2>::EntityRecord);
+    std::string inverted_part = bytes;
+    Snapshot<2>::PartRecord part;
+    std::memcpy(&part, bytes.data() + parts_offset, sizeof(part));
+    std::swap(part.min[1], part.max[1]);
+    part.max[1] -= 1;
+    std::memcpy(inverted_part.data() + parts_offset, &part, sizeof(part));
+    EXPECT_EQ(Snapshot<2>::read(loaded, as_span(inverted_part)), nvl::None);
+    EXPECT_EQ(loaded.num_alive(), 0);
+}
+
+} // namespace
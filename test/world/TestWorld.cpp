@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "nvl/actor/Actor.h"
 #include "nvl/entity/Block.h"
 #include "nvl/material/Bulwark.h"
@@ -32,8 +37,14 @@ using nvl::Block;
 using nvl::Box;
 using nvl::Bulwark;
 using nvl::Color;
+using nvl::Destroy;
+using nvl::Hit;
+using nvl::List;
 using nvl::Material;
+using nvl::Message;
+using nvl::Notify;
 using nvl::Pos;
+using nvl::Status;
 using nvl::TestMaterial;
 using nvl::World;
 using nvl::test::NullWindow;
@@ -105,10 +116,9 @@ TEST(TestWorld, stop_when_fallen) {
     params.maximum_y = 15;
     auto *world = window.open<World<2>>();
     world->set_hud(false);
-    auto test_material = Material::get<TestMaterial>(Color::kBlack);
-    auto bulwark = Material::get<Bulwark>();
-    test_material->outline = false;
-    bulwark->outline = false;
+    const auto no_outline = [](nvl::AbstractMaterial &material) { material.outline = false; };
+    const auto test_material = Material::get<TestMaterial>(Color::kBlack).with(no_outline);
+    const auto bulwark = Material::get<Bulwark>().with(no_outline);
     world->spawn<Block<2>>(Pos<2>(4, 0), Box<2>({0, 0}, {0, 0}), test_material);
     world->spawn<Block<2>>(Pos<2>(0, 8), Box<2>({0, 0}, {9, 0}), bulwark);
     for (I64 i = 0; i < 10; ++i) {
@@ -119,6 +129,617 @@ TEST(TestWorld, stop_when_fallen) {
     }
 }
 
+TEST(TestWorld, stop_when_fallen_3d) {
+    NullWindow window;
+    World<3> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<3>>(Pos<3>::zero, Box<3>({0, 20, 0}, {20, 25, 20}), bulwark);
+    const Actor actor = world.spawn<Block<3>>(Pos<3>::zero, Box<3>({5, 0, 5}, {10, 5, 10}), material);
+    for (U64 i = 0; i < 20; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(actor.dyn_cast<Block<3>>()->bbox().max[1], 19);
+    EXPECT_EQ(world.num_awake(), 0);
+}
+
+/// Block which exposes whether it is resting on something.
+struct ProbeBlock final : Block<2> {
+    using Block::Block;
+    using Block::has_below;
+};
+
+TEST(TestWorld, has_below) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    // Cut a notch out of the top of a block, so that its bounding box is below the floating block but its parts are not
+    const Actor notched = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({50, 90}, {79, 99}), material);
+    world.send<Hit<2>>(nullptr, notched, Box<2>({60, 90}, {69, 94}), 1000);
+    world.tick();
+    ASSERT_EQ(world.num_alive(), 2);
+
+    const Actor resting = world.spawn<ProbeBlock>(Pos<2>(0, 90), Box<2>({0, 0}, {9, 9}), material);
+    const Actor floating = world.spawn<ProbeBlock>(Pos<2>(60, 80), Box<2>({0, 0}, {9, 9}), material);
+    EXPECT_TRUE(resting.dyn_cast<ProbeBlock>()->has_below());
+    EXPECT_FALSE(floating.dyn_cast<ProbeBlock>()->has_below());
+}
+
+TEST(TestWorld, reset_accel_when_resting) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    const Actor actor = world.spawn<Block<2>>(Pos<2>(0, 0), Box<2>({0, 0}, {9, 9}), material);
+    const auto *block = actor.dyn_cast<Block<2>>();
+    for (U64 i = 0; i < 100 && world.num_awake() > 0; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(block->bbox().max[1], 99);
+    EXPECT_EQ(block->velocity(), Pos<2>::zero);
+    EXPECT_EQ(block->accel(), Pos<2>::zero);
+}
+
+/// Block which counts the number of kMoved notifications it has received.
+struct NotifiedBlock final : Block<2> {
+    using Block::Block;
+    Status tick(const List<Message> &messages) override {
+        for (const Message &message : messages) {
+            if (const auto *notify = message.dyn_cast<Notify>(); notify && notify->cause == Notify::kMoved) {
+                ++moved;
+            }
+        }
+        return Block::tick(messages);
+    }
+    U64 moved = 0;
+};
+
+TEST(TestWorld, notify_above_when_starting_to_move) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>(0, 0), Box<2>({0, 0}, {9, 9}), material);
+    const Actor above = world.spawn<NotifiedBlock>(Pos<2>(0, -10), Box<2>({0, 0}, {9, 9}), material);
+    // The block below starts falling on the first tick, and continues falling for the next few
+    for (U64 i = 0; i < 4; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(above.dyn_cast<NotifiedBlock>()->moved, 1);
+}
+
+/// Block which counts the number of times it has been ticked.
+struct CountingBlock final : Block<2> {
+    using Block::Block;
+    Status tick(const List<nvl::Message> &messages) override {
+        ++ticks;
+        return Block::tick(messages);
+    }
+    pure bool is_ballistic() const override { return false; } // Always ticked
+    U64 ticks = 0;
+};
+
+/// Block which counts the number of times it has been ticked, but may be moved without being ticked in free fall.
+struct BallisticBlock final : Block<2> {
+    using Block::Block;
+    Status tick(const List<nvl::Message> &messages) override {
+        ++ticks;
+        return Block::tick(messages);
+    }
+    U64 ticks = 0;
+};
+
+TEST(TestWorld, sleep_when_resting) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    // Two adjacent columns of blocks
+    List<Actor> blocks;
+    for (I64 i = 0; i < 3; ++i) {
+        blocks.push_back(world.spawn<CountingBlock>(Pos<2>(0, 90 - 10 * i), Box<2>({0, 0}, {9, 9}), material));
+        blocks.push_back(world.spawn<CountingBlock>(Pos<2>(10, 90 - 10 * i), Box<2>({0, 0}, {9, 9}), material));
+    }
+    world.tick();
+    EXPECT_EQ(world.num_awake(), 0);
+    EXPECT_EQ(world.num_asleep(), 7);
+    for (const Actor &actor : blocks) {
+        EXPECT_EQ(actor.dyn_cast<CountingBlock>()->ticks, 1);
+    }
+
+    // Partially hitting the top of the first column changes it, which notifies all its neighbors.
+    // Only the block's dependents (none) should be woken by this, not its supports or neighbors in the next column.
+    const Actor top = blocks[4];
+    world.send<Hit<2>>(nullptr, top, Box<2>({0, 70}, {2, 72}), 1000);
+    world.tick();
+    world.tick();
+    EXPECT_EQ(world.num_awake(), 0);
+    EXPECT_EQ(top.dyn_cast<CountingBlock>()->tree().size(), 2); // Sanity check that the hit removed the corner
+    for (const Actor &actor : blocks) {
+        EXPECT_EQ(actor.dyn_cast<CountingBlock>()->ticks, actor == top ? 2 : 1);
+    }
+}
+
+TEST(TestWorld, wake_island_when_support_dies) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    const Actor pedestal = world.spawn<Block<2>>(Pos<2>(0, 50), Box<2>({0, 0}, {9, 49}), material);
+    List<Actor> stack;
+    for (I64 i = 0; i < 3; ++i) {
+        stack.push_back(world.spawn<Block<2>>(Pos<2>(0, 40 - 10 * i), Box<2>({0, 0}, {9, 9}), material));
+    }
+    world.tick();
+    EXPECT_EQ(world.num_awake(), 0);
+
+    // Destroying the pedestal should wake the entire stack resting on it at once
+    world.send<Destroy>(nullptr, pedestal, Destroy::kOutOfBounds);
+    world.tick();
+    EXPECT_EQ(world.num_alive(), 4);
+    EXPECT_EQ(world.num_awake(), 3);
+    for (const Actor &actor : stack) {
+        EXPECT_FALSE(world.is_asleep(actor));
+    }
+
+    for (U64 i = 0; i < 100 && world.num_awake() > 0; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(world.num_awake(), 0);
+    for (I64 i = 0; i < 3; ++i) {
+        EXPECT_EQ(stack[i].dyn_cast<Block<2>>()->bbox().max[1], 99 - 10 * i);
+    }
+}
+
+TEST(TestWorld, static_and_dynamic_index) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor ground = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    const Actor block = world.spawn<Block<2>>(Pos<2>(0, 50), Box<2>({0, 0}, {9, 9}), material);
+    EXPECT_TRUE(world.is_static(ground));
+    EXPECT_FALSE(world.is_static(block));
+    EXPECT_EQ(world.static_entities().size(), 1);
+    EXPECT_EQ(world.dynamic_entities().size(), 1);
+    EXPECT_EQ(world.num_alive(), 2);
+
+    // Queries see both indices
+    const List<Actor> found(world.entities(Box<2>({0, 0}, {100, 100})));
+    EXPECT_EQ(found.size(), 2);
+
+    for (U64 i = 0; i < 100 && world.num_awake() > 0; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(block.dyn_cast<Block<2>>()->bbox().max[1], 99);
+
+    // Hitting the terrain splits it into new static entities, and the block resting on it stays supported
+    world.send<Hit<2>>(nullptr, ground, Box<2>({50, 100}, {60, 110}), 1000);
+    world.tick();
+    EXPECT_EQ(world.static_entities().size(), 2);
+    EXPECT_EQ(world.dynamic_entities().size(), 1);
+    for (const Actor &actor : world.static_entities().items()) {
+        EXPECT_TRUE(world.is_static(actor));
+        EXPECT_FALSE(actor.dyn_cast<Block<2>>()->falls());
+    }
+    for (U64 i = 0; i < 100 && world.num_awake() > 0; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(block.dyn_cast<Block<2>>()->bbox().max[1], 99);
+}
+
+TEST(TestWorld, stale_handles) {
+    NullWindow window;
+    World<2> world(&window);
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor a = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 0}, {9, 9}), material);
+    const Actor b = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({20, 0}, {29, 9}), material);
+    EXPECT_TRUE(a.id().valid());
+    EXPECT_NE(a.id(), b.id());
+    EXPECT_EQ(a->self(), a);
+    EXPECT_TRUE(world.has(a));
+    EXPECT_EQ(world.actors().size(), 2);
+
+    world.send<Destroy>(nullptr, a, Destroy::kOutOfBounds);
+    world.tick();
+    EXPECT_FALSE(world.has(a));
+    EXPECT_TRUE(world.has(b));
+    EXPECT_EQ(world.num_alive(), 1);
+
+    // Messages to stale handles are dropped, even if the slot is reused
+    const Actor c = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({40, 0}, {49, 9}), material);
+    EXPECT_EQ(c.id().index, a.id().index);
+    EXPECT_NE(c, a);
+    EXPECT_FALSE(world.has(a));
+    world.send<Destroy>(nullptr, a, Destroy::kOutOfBounds);
+    world.tick();
+    EXPECT_TRUE(world.has(c));
+}
+
+TEST(TestWorld, freeze_outside_active_region) {
+    NullWindow window("Test", {100, 100});
+    World<2>::Params params;
+    params.active_screens = 1; // Active region is x in [-100, 200]
+    World<2> world(&window, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {2000, 110}), bulwark);
+    const Actor near = world.spawn<Block<2>>(Pos<2>(50, 0), Box<2>({0, 0}, {9, 9}), material);
+    const Actor far = world.spawn<Block<2>>(Pos<2>(1000, 0), Box<2>({0, 0}, {9, 9}), material);
+    for (U64 i = 0; i < 50; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(near.dyn_cast<Block<2>>()->bbox().max[1], 99);
+    EXPECT_EQ(far.dyn_cast<Block<2>>()->loc(), Pos<2>(1000, 0)); // Frozen in place
+    EXPECT_EQ(world.num_awake(), 1);
+    EXPECT_EQ(world.num_inactive(), 1);
+
+    // Moving the view brings the frozen block into the active region, where it resumes falling
+    world.set_view({950, 0});
+    for (U64 i = 0; i < 50; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(far.dyn_cast<Block<2>>()->bbox().max[1], 99);
+    EXPECT_EQ(world.num_awake(), 0);
+    EXPECT_EQ(world.num_inactive(), 0);
+}
+
+TEST(TestWorld, reduced_rate_outside_active_region) {
+    World<2>::Params params;
+    params.inactive_period = 4;
+    World<2> world(nullptr, params);
+    world.add_interest(Box<2>({0, 0}, {100, 1000}));
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    const Actor near = world.spawn<Block<2>>(Pos<2>(50, 0), Box<2>({0, 0}, {9, 9}), material);
+    const Actor far = world.spawn<Block<2>>(Pos<2>(1000, 0), Box<2>({0, 0}, {9, 9}), material);
+    const auto *near_block = near.dyn_cast<Block<2>>();
+    const auto *far_block = far.dyn_cast<Block<2>>();
+    for (U64 i = 0; i < 4; ++i) {
+        world.tick();
+    }
+    // The far block is only ticked on the first of every 4 ticks
+    EXPECT_EQ(near_block->accel(), world.kGravity * 4);
+    EXPECT_EQ(far_block->accel(), world.kGravity);
+    world.tick();
+    EXPECT_EQ(far_block->accel(), world.kGravity * 2);
+    EXPECT_EQ(world.num_inactive(), 0);
+    world.tick();
+    EXPECT_EQ(far_block->accel(), world.kGravity * 2);
+    EXPECT_EQ(world.num_inactive(), 1);
+}
+
+TEST(TestWorld, stream_distant_chunks) {
+    NullWindow window("Test", {100, 100});
+    World<2>::Params params;
+    params.active_screens = 1;
+    params.resident_chunks = 1;
+    params.page_dir = testing::TempDir();
+    World<2> world(&window, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    for (const I64 x : {0, 5000, 9000}) {
+        world.spawn<Block<2>>(Pos<2>(x, 100), Box<2>({0, 0}, {200, 10}), bulwark);
+        world.spawn<Block<2>>(Pos<2>(x + 50, 0), Box<2>({0, 0}, {9, 9}), material);
+    }
+    ASSERT_TRUE(world.is_streaming());
+    world.tick();
+    EXPECT_EQ(world.num_alive(), 2);
+    EXPECT_EQ(world.num_paged(), 2);
+    EXPECT_TRUE(world.is_paged(World<2>::chunk(Box<2>::unit(Pos<2>(5000, 0)))));
+    EXPECT_TRUE(world.entities(Box<2>({4096, 0}, {6000, 200})).empty());
+
+    // Chunks are loaded back once the view nears them, and the view's previous chunk is paged out
+    world.set_view({5000, 0});
+    world.tick();
+    world.await_pages();
+    EXPECT_EQ(world.num_alive(), 4);
+    EXPECT_EQ(world.num_paged(), 1);
+    for (U64 i = 0; i < 50; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(world.num_alive(), 2);
+    EXPECT_EQ(world.num_paged(), 2);
+    EXPECT_EQ(world.num_awake(), 0);
+    // The block in the loaded chunk was frozen while paged out, and has since fallen onto the loaded terrain
+    const List<Actor> blocks(world.entities(Box<2>({5050, 0}, {5059, 99})));
+    ASSERT_EQ(blocks.size(), 1);
+    EXPECT_EQ(blocks[0].dyn_cast<Block<2>>()->bbox(), Box<2>({5050, 90}, {5059, 99}));
+}
+
+TEST(TestWorld, stream_keeps_scheduled_messages) {
+    NullWindow window("Test", {100, 100});
+    World<2>::Params params;
+    params.active_screens = 1;
+    params.resident_chunks = 1;
+    World<2> world(&window, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    List<Actor> blocks;
+    for (const I64 x : {0, 5000, 9000}) {
+        world.spawn<Block<2>>(Pos<2>(x, 100), Box<2>({0, 0}, {200, 10}), bulwark);
+        blocks.push_back(world.spawn<Block<2>>(Pos<2>(x + 50, 0), Box<2>({0, 0}, {9, 9}), material));
+    }
+    world.schedule(blocks[1], 20, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+    world.tick();
+    // The chunk with a scheduled message stays in memory, so the message is not lost
+    EXPECT_EQ(world.num_paged(), 1);
+    EXPECT_FALSE(world.is_paged(World<2>::chunk(Box<2>::unit(Pos<2>(5000, 0)))));
+    for (U64 i = 0; i < 20; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(world.num_scheduled(), 0);
+
+    // The message is handled once the block is in the active region again
+    EXPECT_FALSE(world.is_paged(World<2>::chunk(Box<2>::unit(Pos<2>(5000, 0)))));
+    world.set_view({5000, 0});
+    world.tick();
+    EXPECT_FALSE(world.has(blocks[1]));
+}
+
+TEST(TestWorld, stream_relinks_sleeping_dependents) {
+    NullWindow window("Test", {100, 100});
+    World<2>::Params params;
+    params.active_screens = 1;
+    params.resident_chunks = 1;
+    World<2> world(&window, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    // The block rests on the terrain in the chunk below it
+    const Box<2> terrain({5000, 0}, {5200, 10});
+    world.spawn<Block<2>>(Pos<2>::zero, terrain, bulwark);
+    const Actor block = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({5050, -10}, {5059, -1}), material);
+    // Keeps the block's chunk in memory
+    world.schedule(block, 1000, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+    world.set_view({5000, -50});
+    for (U64 i = 0; i < 3; ++i) {
+        world.tick();
+    }
+    ASSERT_TRUE(world.is_asleep(block));
+
+    // Page out the terrain, but not the block resting on it
+    world.set_view({0, 0});
+    for (U64 i = 0; i < 2 * World<2>::kEvictPeriod && !world.is_paged(World<2>::chunk(terrain)); ++i) {
+        world.tick();
+    }
+    ASSERT_TRUE(world.is_paged(World<2>::chunk(terrain)));
+    EXPECT_TRUE(world.is_asleep(block));
+
+    // Once loaded again, the terrain has a new handle, and destroying it wakes the block
+    world.set_view({5000, -50});
+    world.tick();
+    world.await_pages();
+    const List<Actor> loaded(world.entities(terrain));
+    ASSERT_EQ(loaded.size(), 1);
+    world.send<Destroy>(nullptr, loaded[0], Destroy::kRemoved);
+    world.tick();
+    EXPECT_FALSE(world.is_asleep(block));
+}
+
+TEST(TestWorld, stream_pages_per_world) {
+    NullWindow window("Test", {100, 100});
+    World<2>::Params params;
+    params.active_screens = 1;
+    params.resident_chunks = 1;
+    params.page_dir = testing::TempDir() + "/stream_pages_per_world";
+    std::filesystem::remove_all(params.page_dir);
+    std::filesystem::create_directories(params.page_dir);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    {
+        World<2> a(&window, params);
+        World<2> b(&window, params);
+        for (World<2> *world : {&a, &b}) {
+            for (const I64 x : {0, 5000, 9000}) {
+                world->spawn<Block<2>>(Pos<2>(x, 100), Box<2>({0, 0}, {200, 10}), bulwark);
+                world->spawn<Block<2>>(Pos<2>(x + 50, 0), Box<2>({0, 0}, {9, 9}), material);
+            }
+            world->tick();
+            EXPECT_EQ(world->num_paged(), 2);
+        }
+        // Each world pages out to a directory of its own
+        U64 num_dirs = 0;
+        for (const auto &entry : std::filesystem::directory_iterator(params.page_dir)) {
+            EXPECT_TRUE(entry.is_directory());
+            EXPECT_EQ(std::distance(std::filesystem::directory_iterator(entry), {}), 2);
+            num_dirs += 1;
+        }
+        EXPECT_EQ(num_dirs, 2);
+
+        // Pages which cannot be read are reported, and their chunks stay paged
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(params.page_dir)) {
+            if (entry.is_regular_file()) {
+                std::filesystem::resize_file(entry.path(), 0);
+            }
+        }
+        a.set_view({5000, 0});
+        a.tick();
+        a.await_pages();
+        EXPECT_EQ(a.num_alive(), 2);
+        EXPECT_TRUE(a.is_paged(World<2>::chunk(Box<2>::unit(Pos<2>(5000, 0)))));
+    }
+    // The directories of pages are removed along with their worlds
+    EXPECT_TRUE(std::filesystem::is_empty(params.page_dir));
+}
+
+TEST(TestWorld, scheduled_message) {
+    World<2> world(nullptr);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 10}, {100, 20}), bulwark);
+    const Actor block = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 0}, {9, 9}), material);
+    const Actor removed = world.spawn<Block<2>>(Pos<2>(50, 0), Box<2>({0, 0}, {9, 9}), material);
+    world.schedule(block, 100, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+    world.schedule(removed, 50, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+    world.send<Destroy>(nullptr, removed, Destroy::kRemoved);
+    EXPECT_EQ(world.num_scheduled(), 2);
+
+    // The block sleeps until the scheduled message wakes it
+    for (U64 i = 0; i < 99; ++i) {
+        world.tick();
+    }
+    EXPECT_EQ(world.num_awake(), 0);
+    EXPECT_TRUE(world.has(block));
+    EXPECT_FALSE(world.has(removed));
+    EXPECT_EQ(world.num_scheduled(), 1); // The message to the removed block was dropped
+    world.tick();
+    EXPECT_FALSE(world.has(block));
+    EXPECT_EQ(world.num_scheduled(), 0);
+}
+
+/// Returns a description of every entity in the world which is independent of the order entities are stored in.
+std::string describe(const World<2> &world) {
+    std::vector<std::string> entities;
+    for (const Actor &actor : world.actors()) {
+        const auto *block = actor.dyn_cast<Block<2>>();
+        std::stringstream ss;
+        ss << block->bbox() << " " << block->velocity() << " " << block->accel() << " " << block->tree().size();
+        entities.push_back(ss.str());
+    }
+    std::sort(entities.begin(), entities.end());
+    std::string result;
+    for (const std::string &entity : entities) {
+        result += entity + "\n";
+    }
+    return result;
+}
+
+TEST(TestWorld, restore) {
+    World<2>::Params params;
+    params.history = 24;
+    World<2> world(nullptr, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 100}, {100, 110}), bulwark);
+    for (I64 i = 0; i < 4; ++i) {
+        world.spawn<Block<2>>(Pos<2>(20 * i, 10 * i), Box<2>({0, 0}, {9, 9}), material);
+    }
+    // Hits the blocks, changing their parts, and destroys the last block
+    const auto disturb = [&world] {
+        for (I64 j = 0; j < 3; ++j) {
+            const Box<2> hit({20 * j + 4, 0}, {20 * j + 5, 200});
+            world.send<Hit<2>>(nullptr, world.entities(hit), hit, 1);
+        }
+        world.send<Destroy>(nullptr, world.entities(Box<2>({60, 0}, {69, 99})), Destroy::kRemoved);
+    };
+    List<std::string> states = {describe(world)};
+    for (U64 i = 0; i < 30; ++i) {
+        if (i == 8) {
+            disturb();
+        }
+        world.tick();
+        states.push_back(describe(world));
+    }
+    EXPECT_EQ(world.ticks(), 30);
+    EXPECT_FALSE(world.can_restore(6));
+    EXPECT_FALSE(world.restore(31));
+
+    // Restore to before the blocks were broken, which recreates them
+    const U64 num_alive = world.num_alive();
+    ASSERT_TRUE(world.restore(20));
+    EXPECT_EQ(world.ticks(), 20);
+    EXPECT_EQ(describe(world), states[20]);
+    ASSERT_TRUE(world.restore(7));
+    EXPECT_EQ(describe(world), states[7]);
+    EXPECT_EQ(world.num_alive(), 5);
+    EXPECT_FALSE(world.can_restore(8)); // Later ticks are discarded once restored
+
+    // Replaying from the restored tick reaches the same state
+    for (U64 i = 7; i < 30; ++i) {
+        if (i == 8) {
+            disturb();
+        }
+        world.tick();
+        EXPECT_EQ(describe(world), states[i + 1]);
+    }
+    EXPECT_EQ(world.num_alive(), num_alive);
+}
+
+TEST(TestWorld, restore_scheduled_messages) {
+    World<2>::Params params;
+    params.history = 24;
+    World<2> world(nullptr, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 10}, {100, 20}), bulwark);
+    const Actor a = world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 0}, {9, 9}), material);
+    const Actor b = world.spawn<Block<2>>(Pos<2>(50, 0), Box<2>({0, 0}, {9, 9}), material);
+    world.schedule(a, 10, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+    List<std::string> states = {describe(world)};
+    for (U64 i = 0; i < 20; ++i) {
+        if (i == 5) {
+            world.schedule(b, 20, Message::get<Destroy>(nullptr, Destroy::kRemoved));
+        }
+        world.tick();
+        states.push_back(describe(world));
+    }
+    EXPECT_FALSE(world.has(a));
+    EXPECT_EQ(world.num_scheduled(), 1);
+
+    // The message to `a` is scheduled again, and the message scheduled after tick 3 is discarded
+    ASSERT_TRUE(world.restore(3));
+    EXPECT_EQ(world.num_scheduled(), 1);
+    EXPECT_EQ(describe(world), states[3]);
+    for (U64 i = 3; i < 20; ++i) {
+        world.tick();
+        EXPECT_EQ(describe(world), states[i + 1]);
+    }
+    EXPECT_EQ(world.num_alive(), 2);
+    EXPECT_EQ(world.num_scheduled(), 0);
+}
+
+/// Drops scattered blocks and stacked pairs of blocks of type T onto the ground, returning the state of the world
+/// after each tick and the total number of times the scattered blocks were ticked.
+template <typename T>
+std::pair<std::vector<std::string>, U64> drop_blocks(const World<2>::Params &params = World<2>::Params()) {
+    World<2> world(nullptr, params);
+    const auto bulwark = Material::get<Bulwark>();
+    const auto material = Material::get<TestMaterial>(Color::kBlack);
+    world.spawn<Block<2>>(Pos<2>::zero, Box<2>({0, 1000}, {1000, 1010}), bulwark);
+    List<Actor> scattered;
+    for (I64 i = 0; i < 10; ++i) {
+        scattered.push_back(world.spawn<T>(Pos<2>(i * 50, i * 37 % 200), Box<2>({0, 0}, {9, 9}), material));
+        world.spawn<T>(Pos<2>(i * 50 + 20, 500), Box<2>({0, 0}, {9, 9}), material);
+        world.spawn<T>(Pos<2>(i * 50 + 20, 490), Box<2>({0, 0}, {9, 9}), material);
+    }
+    std::vector<std::string> states;
+    for (U64 i = 0; i < 100; ++i) {
+        world.tick();
+        states.push_back(describe(world));
+    }
+    EXPECT_EQ(world.num_awake(), 0);
+    U64 ticks = 0;
+    for (const Actor &actor : scattered) {
+        ticks += actor.dyn_cast<T>()->ticks;
+    }
+    return {states, ticks};
+}
+
+TEST(TestWorld, batch_free_fall) {
+    const auto [expected, ticked] = drop_blocks<CountingBlock>();
+    const auto [actual, batched] = drop_blocks<BallisticBlock>();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (U64 i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i], expected[i]) << "Tick #" << i;
+    }
+    // Blocks in contact are always ticked, but scattered blocks only when starting to fall and when nearing the ground
+    EXPECT_LT(batched, ticked / 2);
+}
+
+TEST(TestWorld, hash_grid_index) {
+    World<2>::Params params;
+    params.index = World<2>::IndexKind::kHashGrid;
+    const auto [expected, _] = drop_blocks<CountingBlock>();
+    const auto [actual, __] = drop_blocks<CountingBlock>(params);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (U64 i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i], expected[i]) << "Tick #" << i;
+    }
+}
+
 struct FuzzFall : nvl::test::FuzzingTestFixture<Box<2>, Pos<2>, Box<2>, I64, I64> {
     FuzzFall() = default;
 };